@@ -22,6 +22,12 @@ layout(location = 0) in VertexData {
 }
 fs_in;
 
+#ifdef MULTI_DRAW
+// Geometry.vert (from DrawData)
+layout(location = 10) flat in int v_MaterialFlags;
+#  define u_MaterialFlags v_MaterialFlags
+#endif
+
 // -- FUNCTIONS:
 
 vec3 getViewDir() {
@@ -17,7 +17,9 @@
 layout(early_fragment_tests) in;
 #endif
 
+#ifndef MULTI_DRAW
 layout(location = 3) uniform int u_MaterialFlags = 0;
+#endif
 
 layout(location = 0) out vec3 GBuffer0; // .rgb = Normal
 layout(location = 1) out vec4 GBuffer1; // .rgb = Albedo, .a = SpecularWeight
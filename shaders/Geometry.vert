@@ -24,12 +24,19 @@ layout(location = 7) in ivec4 a_Joints;
 layout(location = 8) in vec4 a_Weights;
 #endif
 
+#ifdef MULTI_DRAW
+#  include <Resources/DrawData.glsl>
+#  define u_Transform g_DrawData[gl_DrawID].transform
+
+layout(location = 10) flat out int v_MaterialFlags;
+#else
 struct Transform {
   mat4 modelMatrix;
   mat4 normalMatrix;
   mat4 modelViewProjMatrix;
 };
 layout(location = 0) uniform Transform u_Transform;
+#endif
 
 out gl_PerVertex { vec4 gl_Position; };
 
@@ -81,5 +88,9 @@ void main() {
   vs_out.color = a_Color0;
 #endif
 
+#ifdef MULTI_DRAW
+  v_MaterialFlags = g_DrawData[gl_DrawID].materialFlags;
+#endif
+
   gl_Position = u_Transform.modelViewProjMatrix * vec4(a_Position, 1.0);
 }
@@ -11,7 +11,9 @@
 
 #include <Material.glsl>
 
+#ifndef MULTI_DRAW
 layout(location = 12) uniform int u_MaterialFlags = 0;
+#endif
 layout(location = 13) uniform vec3 u_LightIntensity;
 
 #if BLEND_MODE == BLEND_MODE_OPAQUE
@@ -0,0 +1,23 @@
+#ifndef _DRAW_DATA_GLSL_
+#define _DRAW_DATA_GLSL_
+
+// Per-draw data of a multi-draw indirect batch, indexed with gl_DrawID.
+// BaseGeometryPass.hpp
+
+struct Transform {
+  mat4 modelMatrix;
+  mat4 normalMatrix;
+  mat4 modelViewProjMatrix;
+};
+
+struct DrawData {
+  Transform transform;
+  int materialFlags;
+  // Implicit padding, 12bytes
+};
+
+layout(binding = 2, std430) restrict readonly buffer DrawDataBuffer {
+  DrawData g_DrawData[];
+};
+
+#endif
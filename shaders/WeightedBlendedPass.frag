@@ -43,7 +43,9 @@ _DECLARE_LIGHT_BUFFER(0, g_LightBuffer);
 
 #include <Material.glsl>
 
+#ifndef MULTI_DRAW
 layout(location = 12) uniform int u_MaterialFlags = 0;
+#endif
 
 layout(location = 0) out vec4 Accum;
 layout(location = 1) out float Reveal;
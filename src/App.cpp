@@ -24,6 +24,7 @@
 namespace {
 
 const std::filesystem::path kAssetsDir{"./assets/"};
+const std::filesystem::path kProgramCacheDir{"./cache/programs/"};
 
 ImGuiKey remapKey(int keycode) {
   switch (keycode) {
@@ -265,7 +266,8 @@ ImGuiKey remapKey(int keycode) {
   return ImGuiKey_None;
 }
 
-void showMetricsOverlay() {
+void showMetricsOverlay(const RenderContext &rc, const WorldRenderer &renderer,
+                        const FramePipelineStats &pipeline) {
   const auto windowFlags =
     ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_AlwaysAutoResize |
     ImGuiWindowFlags_NoSavedSettings | ImGuiWindowFlags_NoFocusOnAppearing |
@@ -279,6 +281,176 @@ void showMetricsOverlay() {
   if (ImGui::Begin("MetricsOverlay", nullptr, windowFlags)) {
     const auto frameRate = ImGui::GetIO().Framerate;
     ImGui::Text("%.3f ms/frame (%.1f FPS)", 1000.0f / frameRate, frameRate);
+
+    const auto fbo = rc.getFramebufferCacheStats();
+    const auto numLookups = fbo.numHits + fbo.numMisses;
+    ImGui::Text("FBO cache: %zu (%.1f%% hit rate, %llu evicted)", fbo.numCached,
+                numLookups > 0 ? 100.0 * fbo.numHits / numLookups : 0.0,
+                static_cast<unsigned long long>(fbo.numEvicted));
+
+    const auto bindings = rc.getBindingStats();
+    ImGui::Text("Binds: %u issued, %u elided (%u calls)", bindings.numIssued,
+                bindings.numElided, bindings.numCalls);
+
+    const auto programs = rc.getProgramCacheStats();
+    ImGui::Text("Program cache: %u hits, %u misses (%.1f ms)",
+                programs.numHits, programs.numMisses, programs.buildTime);
+
+    const auto &frameGraph = renderer.getFrameGraphStats();
+    ImGui::Text("FrameGraph: %u builds (%.3f ms avg), %llu reuses "
+                "(%.1f ms saved)",
+                frameGraph.numBuilds, frameGraph.averageBuildTime,
+                static_cast<unsigned long long>(frameGraph.numReuses),
+                frameGraph.numReuses * frameGraph.averageBuildTime);
+
+    const auto &frameArena = renderer.getFrameArenaStats();
+    ImGui::Text("Frame arena: %u allocations (%u from heap), %.1f KiB",
+                frameArena.numAllocations, frameArena.numHeapAllocations,
+                frameArena.numBytes / 1024.0f);
+
+    const auto &culling = renderer.getCullingStats();
+    ImGui::Text("Culling: %u/%u drawn, shadows %u/%u drawn (%u cascades)",
+                culling.numVisible, culling.numRenderables,
+                culling.numCascadeDraws,
+                culling.numShadowCasters * culling.numCascades,
+                culling.numCascades);
+
+    ImGui::Text("Pipeline: depth %u, update %.2f ms, latency %.1f ms "
+                "(%.1f avg)",
+                pipeline.queueDepth, pipeline.updateTime, pipeline.latency,
+                pipeline.averageLatency);
+  }
+  ImGui::End();
+}
+void showGPUProfilerOverlay(const RenderContext &rc) {
+  const auto windowFlags =
+    ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_AlwaysAutoResize |
+    ImGuiWindowFlags_NoSavedSettings | ImGuiWindowFlags_NoFocusOnAppearing |
+    ImGuiWindowFlags_NoNav | ImGuiWindowFlags_NoMove;
+
+  // Top-right corner.
+  const ImVec2 pad{10.0f, 10.0f};
+  const auto *viewport = ImGui::GetMainViewport();
+  ImGui::SetNextWindowPos(
+    {viewport->WorkPos.x + viewport->WorkSize.x - pad.x,
+     viewport->WorkPos.y + pad.y},
+    ImGuiCond_Always, {1.0f, 0.0f});
+
+  ImGui::SetNextWindowBgAlpha(0.35f);
+  if (ImGui::Begin("GPUProfilerOverlay", nullptr, windowFlags)) {
+    const auto &profiler = rc.getGPUProfiler();
+    ImGui::Text("GPU time [ms] (%llu frames dropped)",
+                static_cast<unsigned long long>(
+                  profiler.getNumDroppedFrames()));
+    if (ImGui::BeginTable("Timings", 4, ImGuiTableFlags_SizingFixedFit)) {
+      for (const auto *label : {"Scope", "avg", "min", "max"})
+        ImGui::TableSetupColumn(label);
+      ImGui::TableHeadersRow();
+
+      for (const auto &[name, depth, timing] : profiler.getTimings()) {
+        ImGui::TableNextRow();
+        ImGui::TableNextColumn();
+        // Indent nested scopes.
+        ImGui::Text("%*s%.*s", static_cast<int>(depth * 2), "",
+                    static_cast<int>(name.size()), name.data());
+        for (const auto v : {timing.average, timing.min, timing.max}) {
+          ImGui::TableNextColumn();
+          ImGui::Text("%.3f", v);
+        }
+      }
+      ImGui::EndTable();
+    }
+  }
+  ImGui::End();
+}
+void showRenderStats(const RenderContext &rc) {
+  const auto renderStats = rc.getRenderStats();
+  if (renderStats.empty()) return; // Built without RENDER_STATS.
+
+  if (ImGui::Begin("RenderStats")) {
+    constexpr auto kTableFlags = ImGuiTableFlags_Borders |
+                                 ImGuiTableFlags_RowBg |
+                                 ImGuiTableFlags_SizingFixedFit;
+    if (ImGui::BeginTable("Stats", 7, kTableFlags)) {
+      for (const auto *label : {"Scope", "Draws", "Triangles", "Programs",
+                                "VAOs", "Textures", "Uniforms"}) {
+        ImGui::TableSetupColumn(label);
+      }
+      ImGui::TableHeadersRow();
+
+      for (const auto &[name, depth, stats] : renderStats) {
+        ImGui::TableNextRow();
+        ImGui::TableNextColumn();
+        ImGui::Text("%*s%s", static_cast<int>(depth * 2), "", name.c_str());
+        ImGui::TableNextColumn();
+        ImGui::Text("%u", stats.numDrawCalls);
+        ImGui::TableNextColumn();
+        ImGui::Text("%llu",
+                    static_cast<unsigned long long>(stats.numTriangles));
+        for (const auto v :
+             {stats.numProgramSwitches, stats.numVertexArraySwitches,
+              stats.numTextureBinds, stats.numUniformUploads}) {
+          ImGui::TableNextColumn();
+          ImGui::Text("%u", v);
+        }
+      }
+      ImGui::EndTable();
+    }
+  }
+  ImGui::End();
+}
+void showTransientResources(TransientResources &transientResources) {
+  constexpr auto kMiB = 1024.0f * 1024.0f;
+
+  if (ImGui::Begin("TransientResources")) {
+    auto budget = static_cast<int32_t>(
+      std::min(transientResources.getMemoryBudget(), std::size_t{1} << 40) /
+      (1024 * 1024));
+    auto policy = transientResources.getBudgetPolicy();
+    auto changed = ImGui::InputInt("Budget [MiB]", &budget, 64, 256);
+    changed |= ImGui::Combo("Policy", reinterpret_cast<int32_t *>(&policy),
+                            "Log\0Evict\0");
+    if (changed) {
+      transientResources.setMemoryBudget(
+        std::size_t(std::max(budget, 0)) * 1024 * 1024, policy);
+    }
+
+    const auto showMemory = [kMiB](const char *label,
+                                   const TransientResources::MemoryStats &m) {
+      ImGui::Text("%s: %.1f live, %.1f pooled, %.1f peak (%.1f live) [MiB]",
+                  label, m.live / kMiB, m.pooled / kMiB, m.peak / kMiB,
+                  m.peakLive / kMiB);
+    };
+    showMemory("Textures", transientResources.getTextureMemoryStats());
+    showMemory("Buffers", transientResources.getBufferMemoryStats());
+
+    constexpr auto kTableFlags = ImGuiTableFlags_Borders |
+                                 ImGuiTableFlags_RowBg |
+                                 ImGuiTableFlags_SizingFixedFit;
+    if (ImGui::BeginTable("Pools", 7, kTableFlags)) {
+      for (const auto *label : {"Pool", "Live", "Pooled", "Live [MiB]",
+                                "Pooled [MiB]", "Peak [MiB]", "Peak live"}) {
+        ImGui::TableSetupColumn(label);
+      }
+      ImGui::TableHeadersRow();
+
+      for (const auto &[name, numLive, numPooled, memory] :
+           transientResources.getPoolStats()) {
+        ImGui::TableNextRow();
+        ImGui::TableNextColumn();
+        ImGui::TextUnformatted(name.c_str());
+        for (const auto v : {numLive, numPooled}) {
+          ImGui::TableNextColumn();
+          ImGui::Text("%u", v);
+        }
+        for (const auto v :
+             {memory.live, memory.pooled, memory.peak, memory.peakLive}) {
+          ImGui::TableNextColumn();
+          ImGui::Text("%.2f", v / kMiB);
+        }
+      }
+      ImGui::EndTable();
+    }
   }
   ImGui::End();
 }
@@ -328,6 +500,11 @@ void renderSettingsWidget(RenderSettings &settings) {
 
     ImGui::Separator();
 
+    ImGui::Combo("Culling", reinterpret_cast<int32_t *>(&settings.culling),
+                 "BVH\0Linear\0");
+
+    ImGui::Separator();
+
     ImGui::Text("DebugFlags:");
     ImGui::CheckboxFlags("Wireframe", &settings.debugFlags,
                          DebugFlag_Wireframe);
@@ -345,7 +522,7 @@ void renderSettingsWidget(RenderSettings &settings) {
 }
 
 void cameraController(PerspectiveCamera &camera, const ImVec2 &mouseDelta,
-                      bool mouseButtons[]) {
+                      const bool mouseButtons[]) {
   constexpr auto LMB = 0, RMB = 1;
   constexpr auto kMouseSensitivity = 0.12f;
   constexpr auto kMoveSensitivity = kMouseSensitivity * 0.2f;
@@ -381,6 +558,38 @@ void cameraController(PerspectiveCamera &camera, const ImVec2 &mouseDelta,
   return *std::next(container.begin(), d(gen));
 }
 
+// Random boxes (scattered over the scene) culled at every SIMD level.
+void runCullingBenchmark(const AABB &sceneAABB,
+                         const PerspectiveCamera &camera) {
+  constexpr auto kNumBoxes = 100'000;
+  constexpr auto kNumRuns = 20u;
+
+  std::default_random_engine gen{42};
+  const auto sceneExtent = sceneAABB.getExtent();
+  std::uniform_real_distribution<float> position{0.0f, 1.0f};
+  std::uniform_real_distribution<float> size{0.001f, 0.01f};
+
+  AABBArray aabbs;
+  aabbs.reserve(kNumBoxes);
+  for (auto i = 0; i < kNumBoxes; ++i) {
+    const auto min = sceneAABB.min + sceneExtent * glm::vec3{position(gen),
+                                                             position(gen),
+                                                             position(gen)};
+    aabbs.push_back({.min = min, .max = min + sceneExtent * size(gen)});
+  }
+
+  const auto results = benchmarkCulling(camera.getFrustum(), aabbs, kNumRuns);
+  const auto &scalar = results.front();
+  for (const auto &[level, time, numVisible] : results) {
+    SPDLOG_INFO("Culling {} boxes ({}): {:.3f} ms, {} visible ({:.1f}x)",
+                kNumBoxes, toString(level), time, numVisible,
+                scalar.time / time);
+    if (numVisible != scalar.numVisible)
+      SPDLOG_ERROR("Culling ({}) does not match the scalar path",
+                   toString(level));
+  }
+}
+
 } // namespace
 
 //
@@ -420,10 +629,14 @@ App::App(const Config &config) {
   glfwMakeContextCurrent(m_window);
   glfwSwapInterval(config.verticalSync ? 1 : 0);
 
-  m_renderContext = std::make_unique<RenderContext>();
+  m_renderContext = std::make_unique<RenderContext>(kProgramCacheDir);
   TracyGpuContext;
 
-  m_renderer = std::make_unique<WorldRenderer>(*m_renderContext);
+  m_jobSystem = std::make_unique<JobSystem>(
+    config.numWorkerThreads.value_or(JobSystem::getDefaultNumThreads()));
+  SPDLOG_INFO("JobSystem: {} worker threads", m_jobSystem->getNumThreads());
+
+  m_renderer = std::make_unique<WorldRenderer>(*m_renderContext, *m_jobSystem);
   m_basicShapes = std::make_unique<BasicShapes>(*m_renderContext);
   m_cubemapConverter = std::make_unique<CubemapConverter>(*m_renderContext);
 
@@ -433,6 +646,29 @@ App::App(const Config &config) {
 
   _setupUi();
   _setupScene();
+  // The renderables do not move (no refit needed).
+  m_renderer->buildCullingData(m_renderables);
+
+  // Allocates transient resources (and builds pipelines) up front, so the
+  // first frames do not hitch. Resources of other feature sets are
+  // preallocated later, one set per frame.
+  if (const auto extent = _getSwapchainExtent();
+      extent.width > 0 && extent.height > 0) {
+    m_camera.setPerspective(
+      60.0f, static_cast<float>(extent.width) / extent.height, 0.1f,
+      max3(m_sceneAABB.getExtent()));
+    m_renderer->warmUp(m_renderSettings, extent, m_sceneAABB, m_camera,
+                       m_lights, m_renderables);
+    m_renderContext->endFrame();
+    m_renderer->queueWarmUp(m_renderSettings, extent);
+  }
+  if (config.benchmarkCulling) runCullingBenchmark(m_sceneAABB, m_camera);
+
+  m_pipelineStats.queueDepth = config.frameQueueDepth;
+  if (config.frameQueueDepth > 0) {
+    m_frameQueue =
+      std::make_unique<BoundedQueue<FrameSnapshot>>(config.frameQueueDepth);
+  }
 }
 App::~App() {
   m_uiRenderer.reset();
@@ -443,7 +679,6 @@ App::~App() {
 
 void App::run() {
   using namespace std::chrono_literals;
-  using clock = std::chrono::high_resolution_clock;
 
   constexpr fsec kTargetFrameTime{16ms};
   fsec deltaTime{kTargetFrameTime};
@@ -451,6 +686,15 @@ void App::run() {
   auto &io = ImGui::GetIO();
   ImVec2 lastMousePos{0.0f, 0.0f};
 
+  // GLFW events, ImGui and GL stay on this (render) thread, the update thread
+  // runs the simulation and stays up to frameQueueDepth snapshots ahead.
+  std::jthread updateThread;
+  if (m_frameQueue) {
+    updateThread = std::jthread{
+      [this](std::stop_token stopToken) { _updateLoop(stopToken); }};
+  }
+
+  auto firstFrame = true;
   while (!glfwWindowShouldClose(m_window)) {
     const auto beginTicks = clock::now();
     glfwPollEvents();
@@ -471,33 +715,77 @@ void App::run() {
 
     ImGui::NewFrame();
 
-    m_camera.setPerspective(
-      60.0f, static_cast<float>(swapchainExtent.width) / swapchainExtent.height,
-      0.1f, max3(m_sceneAABB.getExtent()));
-
-    if (!io.WantCaptureMouse)
-      cameraController(m_camera, io.MousePos - lastMousePos, io.MouseDown);
+    {
+      auto input = m_uiInput;
+      input.sampleTime = beginTicks;
+      if (!io.WantCaptureMouse) {
+        const auto mouseDelta = io.MousePos - lastMousePos;
+        input.mouseDelta = {mouseDelta.x, mouseDelta.y};
+        input.mouseButtons = {io.MouseDown[0], io.MouseDown[1]};
+      }
+      input.aspectRatio =
+        static_cast<float>(swapchainExtent.width) / swapchainExtent.height;
+      input.renderSettings = m_renderSettings;
+      _postInput(input);
+
+      // One-shot edits, posted once.
+      m_uiInput.sunColor.reset();
+      m_uiInput.pilotSun = false;
+    }
     lastMousePos = io.MousePos;
 
-    _update(deltaTime);
+    if (!m_frameQueue) {
+      m_snapshot = _simulate(_takeInput(), deltaTime);
+    } else if (auto snapshot = m_frameQueue->pop(); snapshot) {
+      m_snapshot = std::move(*snapshot);
+    }
 
-    showMetricsOverlay();
+    showMetricsOverlay(*m_renderContext, *m_renderer, m_pipelineStats);
+    showGPUProfilerOverlay(*m_renderContext);
+    showRenderStats(*m_renderContext);
+    showTransientResources(m_renderer->getTransientResources());
     renderSettingsWidget(m_renderSettings);
+    _showSceneWidget(m_snapshot);
 
-    m_renderer->drawFrame(m_renderSettings, swapchainExtent, m_sceneAABB,
-                          m_camera, m_lights, m_renderables, deltaTime.count());
+    m_renderer->drawFrame(m_snapshot.renderSettings, swapchainExtent,
+                          m_sceneAABB, m_snapshot.camera, m_snapshot.lights,
+                          m_renderables, m_snapshot.deltaTime.count());
 
     ImGui::Render();
     m_uiRenderer->draw(ImGui::GetDrawData());
+    m_renderContext->endFrame();
 
     glfwSwapBuffers(m_window);
     TracyGpuCollect;
 
-    deltaTime = clock::now() - beginTicks;
+    const auto endTicks = clock::now();
+    {
+      constexpr auto kSmoothing = 0.05f;
+      auto &stats = m_pipelineStats;
+      stats.updateTime = m_snapshot.updateTime;
+      stats.latency =
+        std::chrono::duration<float, std::milli>{endTicks -
+                                                 m_snapshot.inputTime}
+          .count();
+      stats.averageLatency += (stats.latency - stats.averageLatency) *
+                              (firstFrame ? 1.0f : kSmoothing);
+    }
+
+    deltaTime = endTicks - beginTicks;
     if (deltaTime > 1s) deltaTime = kTargetFrameTime;
 
+    // Most of the pipelines are built on demand, during the first frame.
+    if (firstFrame) {
+      const auto [numHits, numMisses, numRejected, buildTime] =
+        m_renderContext->getProgramCacheStats();
+      SPDLOG_INFO("Program cache: {} hits, {} misses ({} rejected), {:.2f} ms",
+                  numHits, numMisses, numRejected, buildTime);
+      firstFrame = false;
+    }
+
     FrameMark;
   }
+  // The update thread is stopped (and joined) by the jthread.
 }
 
 void App::_setupUi() {
@@ -586,14 +874,14 @@ void App::_addRenderable(
   uint8_t flags) {
 
   auto id = 0;
-  for (auto &[_, material] : mesh.subMeshes) {
+  for (auto &[_, material, aabb] : mesh.subMeshes) {
     m_renderables.push_back(Renderable{
       .mesh = mesh,
       .subMeshIndex = id++,
       .material = materialOverride ? materialOverride->get() : *material,
       .flags = flags,
       .modelMatrix = m,
-      .aabb = mesh.aabb.transform(m),
+      .aabb = aabb.transform(m),
     });
   }
 }
@@ -651,40 +939,119 @@ void App::_spawnPointLights(uint16_t width, uint16_t depth, float step) {
   }
 }
 
-void App::_update(fsec dt) {
+void App::_postInput(const UpdateInput &input) {
+  std::lock_guard lock{m_inputMutex};
+  auto &pending = m_pendingInput;
+  // Accumulated until the update thread takes it.
+  const auto sampleTime = pending.sampleTime ? pending.sampleTime
+                                             : input.sampleTime;
+  const auto mouseDelta = pending.mouseDelta + input.mouseDelta;
+  const auto sunColor = input.sunColor ? input.sunColor : pending.sunColor;
+  const auto pilotSun = pending.pilotSun || input.pilotSun;
+
+  pending = input;
+  pending.sampleTime = sampleTime;
+  pending.mouseDelta = mouseDelta;
+  pending.sunColor = sunColor;
+  pending.pilotSun = pilotSun;
+}
+App::UpdateInput App::_takeInput() {
+  std::lock_guard lock{m_inputMutex};
+  auto input = m_pendingInput;
+  m_pendingInput.sampleTime.reset();
+  m_pendingInput.mouseDelta = glm::vec2{0.0f};
+  m_pendingInput.sunColor.reset();
+  m_pendingInput.pilotSun = false;
+  return input;
+}
+
+App::FrameSnapshot App::_simulate(const UpdateInput &input, fsec dt) {
+  ZoneScoped;
+
+  const auto beginTicks = clock::now();
+
+  m_camera.setPerspective(60.0f, input.aspectRatio, 0.1f,
+                          max3(m_sceneAABB.getExtent()));
+  cameraController(m_camera, ImVec2{input.mouseDelta.x, input.mouseDelta.y},
+                   input.mouseButtons.data());
+
+  if (auto *light = m_lights.empty() ? nullptr : &m_lights.front(); light) {
+    if (input.sunColor) {
+      light->color = glm::vec3{*input.sunColor};
+      light->intensity = input.sunColor->a;
+    }
+    if (input.pilotSun) light->direction = m_camera.getForward();
+    if (input.animateSun) {
+      auto &direction = light->direction;
+      direction =
+        glm::rotateY(direction, glm::radians(input.sunSpeed) * dt.count());
+    }
+  }
+
+  FrameSnapshot snapshot{
+    .frameIndex = m_numSimulatedFrames++,
+    .inputTime = input.sampleTime.value_or(beginTicks),
+    .deltaTime = dt,
+    .camera = m_camera,
+    .lights = m_lights,
+    .renderSettings = input.renderSettings,
+  };
+  snapshot.updateTime =
+    std::chrono::duration<float, std::milli>{clock::now() - beginTicks}
+      .count();
+  return snapshot;
+}
+void App::_updateLoop(std::stop_token stopToken) {
+  using namespace std::chrono_literals;
+  constexpr fsec kTargetFrameTime{16ms};
+
+  // Wakes up the push below.
+  const std::stop_callback closeQueue{stopToken,
+                                      [this] { m_frameQueue->close(); }};
+
+  auto lastTicks = clock::now();
+  while (!stopToken.stop_requested()) {
+    // Paced by the queue (a slot frees up when a frame is rendered).
+    const auto beginTicks = clock::now();
+    fsec deltaTime = beginTicks - lastTicks;
+    if (deltaTime > 1s) deltaTime = kTargetFrameTime;
+    lastTicks = beginTicks;
+
+    if (!m_frameQueue->push(_simulate(_takeInput(), deltaTime))) break;
+  }
+}
+
+void App::_showSceneWidget(const FrameSnapshot &snapshot) {
   if (ImGui::Begin("Scene")) {
     const auto extent = m_sceneAABB.getExtent();
     ImGui::Text("Extent: [%.2f, %.2f, %.2f]", extent.x, extent.y, extent.z);
 
     if (ImGui::CollapsingHeader("Camera")) {
-      const auto &position = m_camera.getPosition();
+      const auto &position = snapshot.camera.getPosition();
       ImGui::Text("Position = [%.2f, %.2f, %.2f]", position.x, position.y,
                   position.z);
-      const auto &forward = m_camera.getForward();
+      const auto &forward = snapshot.camera.getForward();
       ImGui::Text("Direction = [%.2f, %.2f, %.2f]", forward.x, forward.y,
                   forward.z);
     }
 
-    if (auto *light = m_lights.empty() ? nullptr : &m_lights.front(); light) {
+    // Edits go to the update thread (with the next input).
+    if (const auto *light =
+          snapshot.lights.empty() ? nullptr : &snapshot.lights.front();
+        light) {
       if (ImGui::CollapsingHeader("Sun")) {
         if (glm::vec4 color{light->color, light->intensity};
             ImGui::ColorEdit4("Color", glm::value_ptr(color))) {
-          light->color = glm::vec3{color};
-          light->intensity = color.a;
+          m_uiInput.sunColor = color;
         }
 
-        if (ImGui::Button("Pilot")) {
-          light->direction = m_camera.getForward();
-        }
+        if (ImGui::Button("Pilot")) m_uiInput.pilotSun = true;
         ImGui::SameLine();
-        static bool animate{false};
-        if (ImGui::Button("Animate")) animate = !animate;
-
-        if (animate) {
-          static float speed = 15.0f;
-          ImGui::SliderFloat("deg/s", &speed, 0.01f, 90.0f);
-          auto &direction = light->direction;
-          direction = glm::rotateY(direction, glm::radians(speed) * dt.count());
+        if (ImGui::Button("Animate"))
+          m_uiInput.animateSun = !m_uiInput.animateSun;
+
+        if (m_uiInput.animateSun) {
+          ImGui::SliderFloat("deg/s", &m_uiInput.sunSpeed, 0.01f, 90.0f);
         }
       }
     }
@@ -8,11 +8,21 @@
 #include "MeshCache.hpp"
 #include "MaterialCache.hpp"
 
+#include "BoundedQueue.hpp"
+
 #include <map>
 #include <chrono>
+#include <thread>
 
 using fsec = std::chrono::duration<float>;
 
+struct FramePipelineStats {
+  uint32_t queueDepth{0};
+  float updateTime{0.0f}; // All values in milliseconds.
+  float latency{0.0f};    // Input sampled -> frame presented.
+  float averageLatency{0.0f};
+};
+
 struct GLFWwindow;
 
 class BaseApp {
@@ -31,6 +41,14 @@ public:
     uint32_t width;
     uint32_t height;
     bool verticalSync{true};
+    // Worker threads of the JobSystem (nullopt = one per core, minus the main
+    // thread), 0 = single-threaded (deterministic).
+    std::optional<uint32_t> numWorkerThreads;
+    // Snapshots that the update thread can run ahead of rendering, 0 = no
+    // update thread (update and render in sequence).
+    uint32_t frameQueueDepth{1};
+    // Logs the time of the frustum culling kernels (SIMD vs scalar).
+    bool benchmarkCulling{false};
   };
 
   explicit App(const Config &);
@@ -60,7 +78,42 @@ private:
   void _createSun();
   void _spawnPointLights(uint16_t width, uint16_t depth, float step);
 
-  void _update(fsec dt);
+  using clock = std::chrono::steady_clock;
+
+  // Sampled on the main thread, consumed by the update thread.
+  struct UpdateInput {
+    std::optional<clock::time_point> sampleTime; // The oldest one pending.
+    glm::vec2 mouseDelta{0.0f};
+    std::array<bool, 2> mouseButtons{}; // LMB, RMB
+    float aspectRatio{1.0f};
+    RenderSettings renderSettings;
+
+    std::optional<glm::vec4> sunColor; // rgb + intensity
+    bool pilotSun{false};
+    bool animateSun{false};
+    float sunSpeed{15.0f}; // deg/s
+  };
+  // Everything that a frame is rendered from, immutable once produced.
+  // Renderables are not copied, they do not change after _setupScene.
+  struct FrameSnapshot {
+    uint64_t frameIndex{0};
+    clock::time_point inputTime;
+    fsec deltaTime{0.0f};
+    float updateTime{0.0f}; // In milliseconds.
+
+    PerspectiveCamera camera;
+    std::vector<Light> lights;
+    RenderSettings renderSettings;
+  };
+
+  void _postInput(const UpdateInput &);
+  [[nodiscard]] UpdateInput _takeInput();
+
+  // @brief Runs on the update thread (or inline if the queue depth is 0).
+  [[nodiscard]] FrameSnapshot _simulate(const UpdateInput &, fsec dt);
+  void _updateLoop(std::stop_token);
+
+  void _showSceneWidget(const FrameSnapshot &);
   void _processInput();
 
   [[nodiscard]] Extent2D _getSwapchainExtent() const;
@@ -78,6 +131,16 @@ private:
 
   std::unique_ptr<RenderContext> m_renderContext;
 
+  std::unique_ptr<JobSystem> m_jobSystem;
+
+  std::mutex m_inputMutex;
+  UpdateInput m_pendingInput;
+  UpdateInput m_uiInput; // Edited by the widgets, posted with the next input.
+
+  std::unique_ptr<BoundedQueue<FrameSnapshot>> m_frameQueue;
+  FrameSnapshot m_snapshot; // Rendered (stable address of the camera).
+  FramePipelineStats m_pipelineStats;
+
   RenderSettings m_renderSettings;
   std::unique_ptr<WorldRenderer> m_renderer;
 
@@ -93,7 +156,10 @@ private:
 
   Texture m_skybox;
 
+  // Owned by the update thread (while it runs).
   PerspectiveCamera m_camera;
   std::vector<Light> m_lights;
+  uint64_t m_numSimulatedFrames{0};
+
   std::vector<Renderable> m_renderables;
 };
@@ -0,0 +1,179 @@
+#include "BVH.hpp"
+#include "glm/common.hpp"
+#include "tracy/Tracy.hpp"
+#include <algorithm>
+#include <array>
+#include <numeric>
+#include <limits>
+#include <cassert>
+
+namespace {
+
+constexpr uint32_t kMaxLeafSize{4};
+constexpr uint32_t kNumBins{16};
+
+[[nodiscard]] AABB makeEmpty() {
+  return {
+    .min = glm::vec3{std::numeric_limits<float>::max()},
+    .max = glm::vec3{std::numeric_limits<float>::lowest()},
+  };
+}
+void grow(AABB &aabb, const AABB &other) {
+  aabb.min = glm::min(aabb.min, other.min);
+  aabb.max = glm::max(aabb.max, other.max);
+}
+void grow(AABB &aabb, const glm::vec3 &p) {
+  aabb.min = glm::min(aabb.min, p);
+  aabb.max = glm::max(aabb.max, p);
+}
+[[nodiscard]] float getSurfaceArea(const AABB &aabb) {
+  const auto e = aabb.getExtent();
+  return e.x * e.y + e.y * e.z + e.z * e.x; // Half of it, that is enough.
+}
+
+} // namespace
+
+//
+// BVH class:
+//
+
+void BVH::build(std::span<const AABB> aabbs) {
+  ZoneScoped;
+
+  clear();
+  if (aabbs.empty()) return;
+
+  const auto numPrimitives = static_cast<uint32_t>(aabbs.size());
+  m_primitives.resize(numPrimitives);
+  std::iota(m_primitives.begin(), m_primitives.end(), 0u);
+  m_bounds.assign(aabbs.begin(), aabbs.end());
+  // A binary tree with at least one primitive per leaf.
+  m_nodes.reserve(2 * numPrimitives - 1);
+
+  _buildNode(0, numPrimitives, 0);
+
+  // Now in the order of m_primitives.
+  for (uint32_t i{0}; i < numPrimitives; ++i)
+    m_bounds[i] = aabbs[m_primitives[i]];
+}
+void BVH::refit(std::span<const AABB> aabbs) {
+  ZoneScoped;
+
+  assert(aabbs.size() == m_primitives.size());
+  for (std::size_t i{0}; i < m_primitives.size(); ++i)
+    m_bounds[i] = aabbs[m_primitives[i]];
+
+  // Children follow their parent.
+  for (auto i = m_nodes.size(); i-- > 0;) {
+    auto &node = m_nodes[i];
+    node.bounds = makeEmpty();
+    if (node.isLeaf()) {
+      for (auto j = 0u; j < node.numPrimitives; ++j)
+        grow(node.bounds, m_bounds[node.firstPrimitive + j]);
+    } else {
+      grow(node.bounds, m_nodes[i + 1].bounds);
+      grow(node.bounds, m_nodes[node.rightChild].bounds);
+    }
+  }
+}
+void BVH::clear() {
+  m_nodes.clear();
+  m_primitives.clear();
+  m_bounds.clear();
+}
+
+bool BVH::empty() const { return m_nodes.empty(); }
+std::size_t BVH::getNumPrimitives() const { return m_primitives.size(); }
+std::size_t BVH::getNumNodes() const { return m_nodes.size(); }
+
+uint32_t BVH::_buildNode(uint32_t first, uint32_t count, uint32_t depth) {
+  // m_bounds is in the original order during the build.
+  auto bounds = makeEmpty();
+  auto centroidBounds = makeEmpty();
+  for (auto i = first; i < first + count; ++i) {
+    const auto &aabb = m_bounds[m_primitives[i]];
+    grow(bounds, aabb);
+    grow(centroidBounds, aabb.getCenter());
+  }
+
+  const auto nodeIndex = static_cast<uint32_t>(m_nodes.size());
+  m_nodes.push_back({
+    .bounds = bounds,
+    .firstPrimitive = first,
+    .numPrimitives = count,
+    .rightChild = 0,
+  });
+  if (count <= kMaxLeafSize) return nodeIndex;
+
+  const auto extent = centroidBounds.getExtent();
+  auto axis = 0;
+  if (extent.y > extent[axis]) axis = 1;
+  if (extent.z > extent[axis]) axis = 2;
+
+  const auto begin = m_primitives.begin() + first;
+  const auto end = begin + count;
+  auto middle = begin;
+
+  if (depth < kMaxSAHDepth && extent[axis] > 0.0f) {
+    const auto getBin = [&, scale = kNumBins / extent[axis]](uint32_t p) {
+      const auto offset = m_bounds[p].getCenter()[axis] -
+                          centroidBounds.min[axis];
+      return std::min(static_cast<uint32_t>(offset * scale), kNumBins - 1);
+    };
+
+    struct Bin {
+      AABB bounds{makeEmpty()};
+      uint32_t count{0};
+    };
+    std::array<Bin, kNumBins> bins;
+    for (auto it = begin; it != end; ++it) {
+      auto &bin = bins[getBin(*it)];
+      grow(bin.bounds, m_bounds[*it]);
+      ++bin.count;
+    }
+
+    // Sweep from the right, then from the left (split after bin i).
+    std::array<float, kNumBins - 1> rightCosts;
+    auto rightBounds = makeEmpty();
+    uint32_t rightCount{0};
+    for (auto i = kNumBins - 1; i > 0; --i) {
+      grow(rightBounds, bins[i].bounds);
+      rightCount += bins[i].count;
+      rightCosts[i - 1] =
+        rightCount > 0 ? rightCount * getSurfaceArea(rightBounds) : 0.0f;
+    }
+    auto bestCost = std::numeric_limits<float>::max();
+    auto bestSplit = 0u;
+    auto leftBounds = makeEmpty();
+    uint32_t leftCount{0};
+    for (auto i = 0u; i < kNumBins - 1; ++i) {
+      grow(leftBounds, bins[i].bounds);
+      leftCount += bins[i].count;
+      if (leftCount == 0 || leftCount == count) continue;
+
+      const auto cost =
+        leftCount * getSurfaceArea(leftBounds) + rightCosts[i];
+      if (cost < bestCost) {
+        bestCost = cost;
+        bestSplit = i;
+      }
+    }
+    middle = std::partition(begin, end, [&](uint32_t p) {
+      return getBin(p) <= bestSplit;
+    });
+  }
+  // Deep, degenerate (centroids in one bin) or overlapping primitives.
+  if (middle == begin || middle == end) {
+    middle = begin + count / 2;
+    std::nth_element(begin, middle, end, [&](uint32_t a, uint32_t b) {
+      return m_bounds[a].getCenter()[axis] < m_bounds[b].getCenter()[axis];
+    });
+  }
+
+  const auto leftCount = static_cast<uint32_t>(middle - begin);
+  _buildNode(first, leftCount, depth + 1);
+  const auto rightChild =
+    _buildNode(first + leftCount, count - leftCount, depth + 1);
+  m_nodes[nodeIndex].rightChild = rightChild;
+  return nodeIndex;
+}
@@ -0,0 +1,191 @@
+#pragma once
+
+#include "Frustum.hpp"
+#include <array>
+#include <span>
+#include <vector>
+#include <bit>
+#include <cassert>
+
+/*
+ * @brief Bounding volume hierarchy over a set of AABBs (primitives), built
+ * with the binned SAH. Nodes are stored depth-first (the left child follows
+ * its parent) and every node covers a contiguous range of primitives.
+ * @remark Primitives are identified by their index in the span given to
+ * build (and refit).
+ */
+class BVH {
+public:
+  BVH() = default;
+  BVH(const BVH &) = delete;
+  BVH(BVH &&) noexcept = default;
+  ~BVH() = default;
+
+  BVH &operator=(const BVH &) = delete;
+  BVH &operator=(BVH &&) noexcept = default;
+
+  void build(std::span<const AABB>);
+  // @brief Updates the bounds of moved primitives (the same ones, in the same
+  // order), keeps the topology. Rebuild if they moved far.
+  void refit(std::span<const AABB>);
+  void clear();
+
+  [[nodiscard]] bool empty() const;
+  [[nodiscard]] std::size_t getNumPrimitives() const;
+  [[nodiscard]] std::size_t getNumNodes() const;
+
+  // @brief Calls visit(primitiveIndex) for every primitive that intersects the
+  // frustum. Subtrees that are fully inside are visited without tests.
+  template <typename Func> void cull(const Frustum &, Func &&visit) const;
+
+  static constexpr uint32_t kMaxFrusta{8};
+  // @brief Tests the frusta in a single traversal, calls
+  // visit(primitiveIndex, frustumMask) once for every primitive that
+  // intersects any of them (bit i = the frustum i).
+  template <typename Func>
+  void cull(std::span<const Frustum>, Func &&visit) const;
+
+private:
+  // @return Index of the node (only needed for a right child, a left child
+  // directly follows its parent).
+  uint32_t _buildNode(uint32_t first, uint32_t count, uint32_t depth);
+
+private:
+  struct Node {
+    AABB bounds;
+    uint32_t firstPrimitive; // Into m_primitives.
+    uint32_t numPrimitives;
+    uint32_t rightChild; // 0 = leaf.
+
+    [[nodiscard]] bool isLeaf() const { return rightChild == 0; }
+  };
+  std::vector<Node> m_nodes;
+  // Reordered, so the primitives of a node are contiguous.
+  std::vector<uint32_t> m_primitives;
+  std::vector<AABB> m_bounds; // Of m_primitives (the same order).
+
+  // Deeper nodes are split in the middle, so the depth (and the traversal
+  // stack) is bounded by kMaxSAHDepth + log2(numPrimitives).
+  static constexpr uint32_t kMaxSAHDepth{24};
+  static constexpr uint32_t kStackSize{64};
+};
+
+template <typename Func> void BVH::cull(const Frustum &frustum,
+                                       Func &&visit) const {
+  if (m_nodes.empty()) return;
+
+  struct Entry {
+    uint32_t node;
+    uint8_t planeMask; // Planes that the parent straddles.
+  };
+  Entry stack[kStackSize];
+  uint32_t stackSize{0};
+  stack[stackSize++] = {0, Frustum::kAllPlanes};
+
+  while (stackSize > 0) {
+    auto [nodeIndex, planeMask] = stack[--stackSize];
+    const auto &node = m_nodes[nodeIndex];
+    const auto first = node.firstPrimitive;
+    const auto last = first + node.numPrimitives;
+
+    switch (frustum.testAABB(node.bounds, planeMask)) {
+    case IntersectionResult::Outside:
+      break;
+    case IntersectionResult::Inside:
+      for (auto i = first; i < last; ++i)
+        visit(m_primitives[i]);
+      break;
+    case IntersectionResult::Intersect:
+      if (node.isLeaf()) {
+        for (auto i = first; i < last; ++i) {
+          auto mask = planeMask;
+          if (frustum.testAABB(m_bounds[i], mask) !=
+              IntersectionResult::Outside) {
+            visit(m_primitives[i]);
+          }
+        }
+      } else {
+        assert(stackSize < kStackSize);
+        stack[stackSize++] = {node.rightChild, planeMask};
+        assert(stackSize < kStackSize);
+        stack[stackSize++] = {nodeIndex + 1, planeMask};
+      }
+      break;
+    }
+  }
+}
+
+template <typename Func>
+void BVH::cull(std::span<const Frustum> frusta, Func &&visit) const {
+  assert(frusta.size() <= kMaxFrusta);
+  if (m_nodes.empty() || frusta.empty()) return;
+
+  struct Entry {
+    uint32_t node;
+    uint8_t frustumMask; // Frusta that the parent intersects.
+    uint8_t insideMask;  // Frusta that the parent is inside of.
+    std::array<uint8_t, kMaxFrusta> planeMasks;
+  };
+  Entry stack[kStackSize];
+  uint32_t stackSize{0};
+  {
+    auto &root = stack[stackSize++];
+    root = {
+      .node = 0,
+      .frustumMask = static_cast<uint8_t>((1u << frusta.size()) - 1u),
+      .insideMask = 0,
+    };
+    root.planeMasks.fill(Frustum::kAllPlanes);
+  }
+
+  while (stackSize > 0) {
+    auto entry = stack[--stackSize];
+    const auto &node = m_nodes[entry.node];
+    const auto first = node.firstPrimitive;
+    const auto last = first + node.numPrimitives;
+
+    for (uint32_t bits = entry.frustumMask & ~entry.insideMask; bits;
+         bits &= bits - 1) {
+      const auto f = std::countr_zero(bits);
+      const auto bit = static_cast<uint8_t>(1u << f);
+      switch (frusta[f].testAABB(node.bounds, entry.planeMasks[f])) {
+      case IntersectionResult::Outside:
+        entry.frustumMask &= ~bit;
+        break;
+      case IntersectionResult::Inside:
+        entry.insideMask |= bit;
+        break;
+      case IntersectionResult::Intersect:
+        break;
+      }
+    }
+    if (entry.frustumMask == 0) continue;
+
+    if (entry.insideMask == entry.frustumMask) {
+      for (auto i = first; i < last; ++i)
+        visit(m_primitives[i], entry.frustumMask);
+    } else if (node.isLeaf()) {
+      for (auto i = first; i < last; ++i) {
+        auto mask = entry.insideMask;
+        for (uint32_t bits = entry.frustumMask & ~entry.insideMask; bits;
+             bits &= bits - 1) {
+          const auto f = std::countr_zero(bits);
+          auto planeMask = entry.planeMasks[f];
+          if (frusta[f].testAABB(m_bounds[i], planeMask) !=
+              IntersectionResult::Outside) {
+            mask |= static_cast<uint8_t>(1u << f);
+          }
+        }
+        if (mask != 0) visit(m_primitives[i], mask);
+      }
+    } else {
+      const auto nodeIndex = entry.node;
+      entry.node = node.rightChild;
+      assert(stackSize < kStackSize);
+      stack[stackSize++] = entry;
+      entry.node = nodeIndex + 1;
+      assert(stackSize < kStackSize);
+      stack[stackSize++] = entry;
+    }
+  }
+}
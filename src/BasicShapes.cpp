@@ -187,6 +187,16 @@ BasicShapes::BasicShapes(RenderContext &rc) : m_renderContext{rc} {
                     })
       .build();
 
+  // Single submesh per shape (bounds of the whole mesh).
+  const AABB planeAABB{
+    .min = {-kPlaneSize, 0.0f, -kPlaneSize},
+    .max = {kPlaneSize, 0.0f, kPlaneSize},
+  };
+  const AABB unitAABB{
+    .min = glm::vec3{-1.0f},
+    .max = glm::vec3{1.0f},
+  };
+
   m_plane = {
     .vertexFormat = vertexFormat,
     .vertexBuffer = m_vertexBuffer,
@@ -199,13 +209,10 @@ BasicShapes::BasicShapes(RenderContext &rc) : m_renderContext{rc} {
               .vertexOffset = 0,
               .numVertices = kNumPlaneVertices,
             },
+          .aabb = planeAABB,
         },
       },
-    .aabb =
-      {
-        .min = {-kPlaneSize, 0.0f, -kPlaneSize},
-        .max = {kPlaneSize, 0.0f, kPlaneSize},
-      },
+    .aabb = planeAABB,
   };
   m_cube = {
     .vertexFormat = vertexFormat,
@@ -219,13 +226,10 @@ BasicShapes::BasicShapes(RenderContext &rc) : m_renderContext{rc} {
               .vertexOffset = kNumPlaneVertices,
               .numVertices = kNumCubeVertices,
             },
+          .aabb = unitAABB,
         },
       },
-    .aabb =
-      {
-        .min = glm::vec3{-1.0f},
-        .max = glm::vec3{1.0f},
-      },
+    .aabb = unitAABB,
   };
   m_sphere = {
     .vertexFormat = vertexFormat,
@@ -241,13 +245,10 @@ BasicShapes::BasicShapes(RenderContext &rc) : m_renderContext{rc} {
               .numVertices = static_cast<uint32_t>(sphereVertices.size()),
               .numIndices = static_cast<uint32_t>(sphereIndices.size()),
             },
+          .aabb = unitAABB,
         },
       },
-    .aabb =
-      {
-        .min = glm::vec3{-1.0f},
-        .max = glm::vec3{1.0f},
-      },
+    .aabb = unitAABB,
   };
 }
 BasicShapes::~BasicShapes() = default;
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cassert>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <optional>
+
+// @brief A blocking FIFO queue of a fixed capacity.
+template <typename T> class BoundedQueue {
+public:
+  explicit BoundedQueue(std::size_t capacity) : m_capacity{capacity} {
+    assert(capacity > 0);
+  }
+  BoundedQueue(const BoundedQueue &) = delete;
+  BoundedQueue(BoundedQueue &&) noexcept = delete;
+  ~BoundedQueue() = default;
+
+  BoundedQueue &operator=(const BoundedQueue &) = delete;
+  BoundedQueue &operator=(BoundedQueue &&) noexcept = delete;
+
+  // @brief Waits for a free slot.
+  // @return false if the queue has been closed (the value is dropped).
+  bool push(T value) {
+    std::unique_lock lock{m_mutex};
+    m_notFull.wait(lock, [this] {
+      return m_closed || m_items.size() < m_capacity;
+    });
+    if (m_closed) return false;
+
+    m_items.push_back(std::move(value));
+    lock.unlock();
+    m_notEmpty.notify_one();
+    return true;
+  }
+  // @brief Waits for an item.
+  // @return nullopt if the queue has been closed.
+  [[nodiscard]] std::optional<T> pop() {
+    std::unique_lock lock{m_mutex};
+    m_notEmpty.wait(lock, [this] { return m_closed || !m_items.empty(); });
+    if (m_closed) return std::nullopt;
+
+    auto value = std::move(m_items.front());
+    m_items.pop_front();
+    lock.unlock();
+    m_notFull.notify_one();
+    return value;
+  }
+
+  // @brief Wakes up the waiting threads, push/pop fail from now on.
+  void close() {
+    {
+      std::lock_guard lock{m_mutex};
+      m_closed = true;
+    }
+    m_notFull.notify_all();
+    m_notEmpty.notify_all();
+  }
+
+  [[nodiscard]] std::size_t getCapacity() const { return m_capacity; }
+
+private:
+  const std::size_t m_capacity;
+
+  std::mutex m_mutex;
+  std::condition_variable m_notFull;
+  std::condition_variable m_notEmpty;
+  std::deque<T> m_items;
+  bool m_closed{false};
+};
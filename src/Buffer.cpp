@@ -2,8 +2,9 @@
 #include "spdlog/spdlog.h"
 
 Buffer::Buffer(Buffer &&other) noexcept
-    : m_id{other.m_id}, m_size{other.m_size}, m_mappedMemory{
-                                                other.m_mappedMemory} {
+    : m_id{other.m_id}, m_size{other.m_size},
+      m_mappedMemory{other.m_mappedMemory}, m_offset{other.m_offset},
+      m_isView{other.m_isView} {
   memset(&other, 0, sizeof(Buffer));
 }
 Buffer::~Buffer() {
@@ -22,6 +23,9 @@ Buffer::operator bool() const { return m_id != GL_NONE; }
 GLsizeiptr Buffer::getSize() const { return m_size; }
 bool Buffer::isMapped() const { return m_mappedMemory != nullptr; }
 
+bool Buffer::isView() const { return m_isView; }
+GLintptr Buffer::getOffset() const { return m_offset; }
+
 Buffer::Buffer(GLuint id, GLsizeiptr size) : m_id{id}, m_size{size} {}
 
 Buffer::operator GLuint() const { return m_id; }
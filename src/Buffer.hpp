@@ -19,6 +19,10 @@ public:
   [[nodiscard]] GLsizeiptr getSize() const;
   [[nodiscard]] bool isMapped() const;
 
+  [[nodiscard]] bool isView() const;
+  // @return Offset into the owning buffer (0 if not a view).
+  [[nodiscard]] GLintptr getOffset() const;
+
 protected:
   Buffer(GLuint id, GLsizeiptr size);
 
@@ -28,4 +32,9 @@ protected:
   GLuint m_id{GL_NONE};
   GLsizeiptr m_size{0};
   void *m_mappedMemory{nullptr};
+
+  // A view is a sub-range [m_offset, m_offset + m_size) of a buffer that is
+  // owned by someone else (e.g. RenderContext upload ring).
+  GLintptr m_offset{0};
+  bool m_isView{false};
 };
@@ -0,0 +1,62 @@
+#include "BufferArena.hpp"
+#include "RenderContext.hpp"
+#include <algorithm>
+#include <cassert>
+
+BufferArena::BufferArena(RenderContext &rc, GLsizeiptr capacity)
+    : m_renderContext{rc}, m_alignment{rc.getBufferOffsetAlignment()} {
+  assert(capacity > 0);
+  m_buffer = m_renderContext.createBuffer(_alignSize(capacity));
+  m_freeRanges.push_back({0, m_buffer.getSize()});
+}
+BufferArena::~BufferArena() { m_renderContext.destroy(m_buffer); }
+
+std::optional<Buffer> BufferArena::allocate(GLsizeiptr size) {
+  assert(size > 0);
+  const auto alignedSize = _alignSize(size);
+  const auto it = std::ranges::find_if(m_freeRanges, [alignedSize](auto &r) {
+    return r.size >= alignedSize;
+  });
+  if (it == m_freeRanges.end()) return std::nullopt;
+
+  // Offsets and sizes are multiples of the alignment, so is the remainder.
+  const auto offset = it->offset;
+  if (it->size == alignedSize) {
+    m_freeRanges.erase(it);
+  } else {
+    it->offset += alignedSize;
+    it->size -= alignedSize;
+  }
+  m_usedSize += alignedSize;
+  return m_renderContext.createBufferView(m_buffer, offset, size);
+}
+void BufferArena::free(Buffer &view) {
+  assert(view.isView());
+  const Range range{view.getOffset(), _alignSize(view.getSize())};
+  m_usedSize -= range.size;
+  m_renderContext.destroy(view);
+
+  auto next = std::ranges::lower_bound(m_freeRanges, range.offset, {},
+                                       &Range::offset);
+  auto it = m_freeRanges.insert(next, range);
+  if (auto nextIt = std::next(it); nextIt != m_freeRanges.end() &&
+                                   it->offset + it->size == nextIt->offset) {
+    it->size += nextIt->size;
+    m_freeRanges.erase(nextIt);
+  }
+  if (it != m_freeRanges.begin()) {
+    if (auto prevIt = std::prev(it);
+        prevIt->offset + prevIt->size == it->offset) {
+      prevIt->size += it->size;
+      m_freeRanges.erase(it);
+    }
+  }
+}
+
+GLsizeiptr BufferArena::getCapacity() const { return m_buffer.getSize(); }
+GLsizeiptr BufferArena::getUsedSize() const { return m_usedSize; }
+bool BufferArena::isEmpty() const { return m_usedSize == 0; }
+
+GLsizeiptr BufferArena::_alignSize(GLsizeiptr size) const {
+  return (size + m_alignment - 1) / m_alignment * m_alignment;
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "Buffer.hpp"
+#include <vector>
+#include <optional>
+
+class RenderContext;
+
+// @brief Suballocates (aligned) views from a single GL buffer.
+// First-fit over a list of free ranges (sorted by offset), neighbouring ranges
+// are merged on free.
+class BufferArena {
+public:
+  BufferArena() = delete;
+  BufferArena(RenderContext &, GLsizeiptr capacity);
+  BufferArena(const BufferArena &) = delete;
+  BufferArena(BufferArena &&) noexcept = delete;
+  ~BufferArena();
+
+  BufferArena &operator=(const BufferArena &) = delete;
+  BufferArena &operator=(BufferArena &&) noexcept = delete;
+
+  // @return std::nullopt if there is no free range that is large enough.
+  [[nodiscard]] std::optional<Buffer> allocate(GLsizeiptr size);
+  // @brief Returns the range of the given view to the arena (and drops it).
+  void free(Buffer &);
+
+  [[nodiscard]] GLsizeiptr getCapacity() const;
+  // @return Bytes taken by allocations (including the alignment padding).
+  [[nodiscard]] GLsizeiptr getUsedSize() const;
+  [[nodiscard]] bool isEmpty() const;
+
+private:
+  [[nodiscard]] GLsizeiptr _alignSize(GLsizeiptr) const;
+
+private:
+  RenderContext &m_renderContext;
+  Buffer m_buffer;
+  GLsizeiptr m_alignment{1};
+
+  struct Range {
+    GLintptr offset;
+    GLsizeiptr size;
+  };
+  std::vector<Range> m_freeRanges;
+  GLsizeiptr m_usedSize{0};
+};
@@ -0,0 +1,202 @@
+#include "CommandList.hpp"
+#include <cstring>
+
+namespace {
+
+enum class CommandType : uint32_t {
+  SetGraphicsPipeline,
+  BindTexture,
+  BindStorageBuffer,
+  Call,
+  MultiDrawArraysIndirect,
+  MultiDrawElementsIndirect,
+};
+
+// Every command starts with it, followed by a payload (if any).
+struct Header {
+  CommandType type;
+  uint32_t size; // Of the whole command (header + payload), aligned.
+};
+
+// Commands (and payloads) are aligned, so the payload can be written in place
+// (e.g. glm::mat4 members of a DrawData).
+constexpr std::size_t kAlignment{16};
+[[nodiscard]] constexpr std::size_t alignUp(std::size_t size) {
+  return (size + kAlignment - 1) & ~(kAlignment - 1);
+}
+
+struct SetGraphicsPipelineCommand {
+  static constexpr auto kType = CommandType::SetGraphicsPipeline;
+  Header header;
+  const GraphicsPipeline *pipeline;
+};
+struct BindTextureCommand {
+  static constexpr auto kType = CommandType::BindTexture;
+  Header header;
+  GLuint unit;
+  const Texture *texture;
+};
+struct BindStorageBufferCommand {
+  static constexpr auto kType = CommandType::BindStorageBuffer;
+  Header header;
+  GLuint index;
+  GLsizeiptr dataSize;
+};
+struct CallCommand {
+  static constexpr auto kType = CommandType::Call;
+  Header header;
+  const std::function<void()> *callback;
+};
+struct MultiDrawArraysIndirectCommand {
+  static constexpr auto kType = CommandType::MultiDrawArraysIndirect;
+  Header header;
+  const VertexBuffer *vertexBuffer;
+  PrimitiveTopology topology;
+  uint32_t drawCount;
+};
+struct MultiDrawElementsIndirectCommand {
+  static constexpr auto kType = CommandType::MultiDrawElementsIndirect;
+  Header header;
+  const VertexBuffer *vertexBuffer;
+  const IndexBuffer *indexBuffer;
+  PrimitiveTopology topology;
+  uint32_t drawCount;
+};
+
+template <typename T> [[nodiscard]] const T &get(const std::byte *command) {
+  return *reinterpret_cast<const T *>(command);
+}
+template <typename T>
+[[nodiscard]] const std::byte *getPayload(const std::byte *command) {
+  return command + alignUp(sizeof(T));
+}
+
+[[nodiscard]] Buffer uploadStream(RenderContext &rc, const void *data,
+                                  GLsizeiptr size) {
+  auto buffer = rc.createStreamBuffer(size);
+  std::memcpy(rc.map(buffer), data, size);
+  return buffer;
+}
+
+} // namespace
+
+//
+// CommandList class:
+//
+
+template <typename T> T &CommandList::_push(std::size_t payloadSize) {
+  const auto offset = m_data.size();
+  const auto size = alignUp(sizeof(T)) + alignUp(payloadSize);
+  // Grows geometrically, and keeps the capacity across clear().
+  m_data.resize(offset + size);
+  auto *command = new (m_data.data() + offset) T{};
+  command->header = {.type = T::kType, .size = static_cast<uint32_t>(size)};
+  return *command;
+}
+
+void CommandList::clear() { m_data.clear(); }
+bool CommandList::empty() const { return m_data.empty(); }
+
+CommandList &CommandList::setGraphicsPipeline(const GraphicsPipeline &gp) {
+  _push<SetGraphicsPipelineCommand>().pipeline = &gp;
+  return *this;
+}
+CommandList &CommandList::bindTexture(GLuint unit, const Texture &texture) {
+  auto &command = _push<BindTextureCommand>();
+  command.unit = unit;
+  command.texture = &texture;
+  return *this;
+}
+CommandList &CommandList::call(const std::function<void()> &callback) {
+  _push<CallCommand>().callback = &callback;
+  return *this;
+}
+
+std::span<DrawArraysIndirectCommand>
+CommandList::multiDrawIndirect(const VertexBuffer &vertexBuffer,
+                               PrimitiveTopology topology,
+                               uint32_t drawCount) {
+  assert(drawCount > 0);
+  auto &command = _push<MultiDrawArraysIndirectCommand>(
+    sizeof(DrawArraysIndirectCommand) * drawCount);
+  command.vertexBuffer = &vertexBuffer;
+  command.topology = topology;
+  command.drawCount = drawCount;
+  return {reinterpret_cast<DrawArraysIndirectCommand *>(
+            reinterpret_cast<std::byte *>(&command) +
+            alignUp(sizeof(command))),
+          drawCount};
+}
+std::span<DrawElementsIndirectCommand>
+CommandList::multiDrawIndirect(const VertexBuffer &vertexBuffer,
+                               const IndexBuffer &indexBuffer,
+                               PrimitiveTopology topology,
+                               uint32_t drawCount) {
+  assert(drawCount > 0);
+  auto &command = _push<MultiDrawElementsIndirectCommand>(
+    sizeof(DrawElementsIndirectCommand) * drawCount);
+  command.vertexBuffer = &vertexBuffer;
+  command.indexBuffer = &indexBuffer;
+  command.topology = topology;
+  command.drawCount = drawCount;
+  return {reinterpret_cast<DrawElementsIndirectCommand *>(
+            reinterpret_cast<std::byte *>(&command) +
+            alignUp(sizeof(command))),
+          drawCount};
+}
+
+void CommandList::replay(RenderContext &rc) const {
+  const auto *command = m_data.data();
+  const auto *const end = command + m_data.size();
+  while (command != end) {
+    const auto &header = get<Header>(command);
+    switch (header.type) {
+    case CommandType::SetGraphicsPipeline:
+      rc.setGraphicsPipeline(
+        *get<SetGraphicsPipelineCommand>(command).pipeline);
+      break;
+    case CommandType::BindTexture: {
+      const auto &[_, unit, texture] = get<BindTextureCommand>(command);
+      rc.bindTexture(unit, *texture);
+    } break;
+    case CommandType::BindStorageBuffer: {
+      const auto &[_, index, dataSize] =
+        get<BindStorageBufferCommand>(command);
+      auto buffer = uploadStream(
+        rc, getPayload<BindStorageBufferCommand>(command), dataSize);
+      rc.bindStorageBuffer(index, buffer).destroy(buffer);
+    } break;
+    case CommandType::Call:
+      (*get<CallCommand>(command).callback)();
+      break;
+    case CommandType::MultiDrawArraysIndirect: {
+      const auto &[_, vertexBuffer, topology, drawCount] =
+        get<MultiDrawArraysIndirectCommand>(command);
+      auto commands = uploadStream(
+        rc, getPayload<MultiDrawArraysIndirectCommand>(command),
+        sizeof(DrawArraysIndirectCommand) * drawCount);
+      rc.multiDrawIndirect(*vertexBuffer, topology, commands, drawCount)
+        .destroy(commands);
+    } break;
+    case CommandType::MultiDrawElementsIndirect: {
+      const auto &[_, vertexBuffer, indexBuffer, topology, drawCount] =
+        get<MultiDrawElementsIndirectCommand>(command);
+      auto commands = uploadStream(
+        rc, getPayload<MultiDrawElementsIndirectCommand>(command),
+        sizeof(DrawElementsIndirectCommand) * drawCount);
+      rc.multiDrawIndirect(*vertexBuffer, *indexBuffer, topology, commands,
+                           drawCount)
+        .destroy(commands);
+    } break;
+    }
+    command += header.size;
+  }
+}
+
+void *CommandList::_bindStorageBuffer(GLuint index, std::size_t size) {
+  assert(size > 0);
+  auto &command = _push<BindStorageBufferCommand>(size);
+  command.index = index;
+  command.dataSize = static_cast<GLsizeiptr>(size);
+  return reinterpret_cast<std::byte *>(&command) + alignUp(sizeof(command));
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "RenderContext.hpp"
+#include <functional>
+#include <span>
+#include <vector>
+
+/*
+ * @brief Records RenderContext commands into a linear buffer. Recording does
+ * not touch GL (hence can be done on any thread), the replay has to happen on
+ * the GL thread.
+ * @remark Recorded objects (pipelines, textures, buffers, callbacks) are
+ * referenced, they have to outlive the replay.
+ */
+class CommandList {
+public:
+  CommandList() = default;
+  CommandList(const CommandList &) = delete;
+  CommandList(CommandList &&) noexcept = default;
+  ~CommandList() = default;
+
+  CommandList &operator=(const CommandList &) = delete;
+  CommandList &operator=(CommandList &&) noexcept = default;
+
+  // @brief Removes all commands (keeps the capacity).
+  void clear();
+  [[nodiscard]] bool empty() const;
+
+  CommandList &setGraphicsPipeline(const GraphicsPipeline &);
+  CommandList &bindTexture(GLuint unit, const Texture &);
+  // @brief The data goes to a stream buffer on replay, write it to the
+  // returned span (invalidated by the next command).
+  template <typename T>
+  [[nodiscard]] std::span<T> bindStorageBuffer(GLuint index, uint32_t count) {
+    return {static_cast<T *>(_bindStorageBuffer(index, sizeof(T) * count)),
+            count};
+  }
+  // @brief Invoked on replay (on the GL thread).
+  CommandList &call(const std::function<void()> &);
+
+  // @return Where to write drawCount commands (invalidated by the next
+  // command).
+  [[nodiscard]] std::span<DrawArraysIndirectCommand>
+  multiDrawIndirect(const VertexBuffer &, PrimitiveTopology,
+                    uint32_t drawCount);
+  [[nodiscard]] std::span<DrawElementsIndirectCommand>
+  multiDrawIndirect(const VertexBuffer &, const IndexBuffer &,
+                    PrimitiveTopology, uint32_t drawCount);
+
+  // @brief Executes the commands in the recorded order.
+  void replay(RenderContext &) const;
+
+private:
+  [[nodiscard]] void *_bindStorageBuffer(GLuint index, std::size_t size);
+
+  template <typename T>
+  [[nodiscard]] T &_push(std::size_t payloadSize = 0);
+
+private:
+  std::vector<std::byte> m_data;
+};
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <memory_resource>
+#include <cstdint>
+#include <mutex>
+
+// @brief Forwards to the upstream resource, counting the allocations.
+// Thread-safe, the upstream calls are serialized.
+class CountingMemoryResource final : public std::pmr::memory_resource {
+public:
+  explicit CountingMemoryResource(std::pmr::memory_resource *upstream)
+      : m_upstream{upstream} {}
+
+  struct Stats {
+    uint32_t numAllocations{0};
+    std::size_t numBytes{0};
+  };
+  [[nodiscard]] const Stats &getStats() const { return m_stats; }
+  void resetStats() { m_stats = {}; }
+
+private:
+  void *do_allocate(std::size_t bytes, std::size_t alignment) override {
+    std::lock_guard lock{m_mutex};
+    ++m_stats.numAllocations;
+    m_stats.numBytes += bytes;
+    return m_upstream->allocate(bytes, alignment);
+  }
+  void do_deallocate(void *p, std::size_t bytes,
+                     std::size_t alignment) override {
+    std::lock_guard lock{m_mutex};
+    m_upstream->deallocate(p, bytes, alignment);
+  }
+  bool do_is_equal(const memory_resource &other) const noexcept override {
+    return this == &other;
+  }
+
+private:
+  std::pmr::memory_resource *m_upstream;
+  std::mutex m_mutex;
+  Stats m_stats;
+};
@@ -11,5 +11,6 @@ void FrameGraphBuffer::destroy(const Desc &desc, void *allocator) {
 }
 
 std::string FrameGraphBuffer::toString(const Desc &desc) {
-  return std::format("size: {} bytes", desc.size);
+  return std::format("size: {} bytes{}", desc.size,
+                     desc.stream ? " (stream)" : "");
 }
@@ -7,6 +7,10 @@ class FrameGraphBuffer {
 public:
   struct Desc {
     GLsizeiptr size;
+    // Suballocated from the upload ring (persistently mapped, CPU writes
+    // only), valid for the current frame.
+    // Otherwise a view of a (GPU side) arena, see TransientResources.
+    bool stream{false};
   };
 
   void create(const Desc &, void *allocator);
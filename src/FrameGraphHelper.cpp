@@ -1,7 +1,11 @@
 #include "FrameGraphHelper.hpp"
-#include "fg/FrameGraph.hpp"
-#include "FrameGraphTexture.hpp"
-#include "FrameGraphBuffer.hpp"
+#include <utility>
+
+namespace {
+
+thread_local TransientDeclarationScope *g_declarationScope{nullptr};
+
+} // namespace
 
 FrameGraphResource importTexture(FrameGraph &fg, const std::string_view name,
                                  Texture *texture) {
@@ -29,3 +33,67 @@ FrameGraphResource importBuffer(FrameGraph &fg, const std::string_view name,
 Buffer &getBuffer(FrameGraphPassResources &resources, FrameGraphResource id) {
   return *resources.get<FrameGraphBuffer>(id).buffer;
 }
+
+//
+// TransientDeclarationScope class:
+//
+
+TransientDeclarationScope::TransientDeclarationScope(
+  TransientResources::Declarations &declarations)
+    : m_declarations{declarations},
+      m_previous{std::exchange(g_declarationScope, this)} {}
+TransientDeclarationScope::~TransientDeclarationScope() {
+  g_declarationScope = m_previous;
+}
+
+void TransientDeclarationScope::_beginPass() { ++m_passIndex; }
+void TransientDeclarationScope::_create(FrameGraphResource id,
+                                        const FrameGraphTexture::Desc &desc) {
+  auto &textures = m_declarations.textures;
+  m_entries[id] = {.isTexture = true, .index = textures.size()};
+  textures.push_back({desc, m_passIndex, m_passIndex});
+}
+void TransientDeclarationScope::_create(FrameGraphResource id,
+                                        const FrameGraphBuffer::Desc &desc) {
+  auto &buffers = m_declarations.buffers;
+  m_entries[id] = {.isTexture = false, .index = buffers.size()};
+  buffers.push_back({desc, m_passIndex, m_passIndex});
+}
+void TransientDeclarationScope::_access(FrameGraphResource id,
+                                        FrameGraphResource result) {
+  // Imported resources are not tracked.
+  const auto it = m_entries.find(id);
+  if (it == m_entries.cend()) return;
+
+  const auto entry = it->second;
+  if (entry.isTexture) {
+    m_declarations.textures[entry.index].lastPass = m_passIndex;
+  } else {
+    m_declarations.buffers[entry.index].lastPass = m_passIndex;
+  }
+  if (result != id) m_entries[result] = entry;
+}
+
+//
+// PassBuilder class:
+//
+
+PassBuilder::PassBuilder(FrameGraph::Builder &builder)
+    : m_builder{builder}, m_scope{g_declarationScope} {
+  if (m_scope) m_scope->_beginPass();
+}
+
+FrameGraphResource PassBuilder::read(FrameGraphResource id) {
+  const auto result = m_builder.read(id);
+  if (m_scope) m_scope->_access(id, result);
+  return result;
+}
+FrameGraphResource PassBuilder::write(FrameGraphResource id) {
+  const auto result = m_builder.write(id);
+  if (m_scope) m_scope->_access(id, result);
+  return result;
+}
+PassBuilder &PassBuilder::setSideEffect() {
+  m_builder.setSideEffect();
+  return *this;
+}
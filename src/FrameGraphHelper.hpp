@@ -1,10 +1,11 @@
 #pragma once
 
-#include "fg/FrameGraphResource.hpp"
+#include "fg/FrameGraph.hpp"
+#include "TransientResources.hpp"
 #include <string_view>
-
-class FrameGraph;
-class FrameGraphPassResources;
+#include <functional>
+#include <unordered_map>
+#include <variant>
 
 class Texture;
 
@@ -20,3 +21,86 @@ importBuffer(FrameGraph &, const std::string_view name, Buffer *);
 
 [[nodiscard]] Buffer &getBuffer(FrameGraphPassResources &,
                                 FrameGraphResource id);
+
+// @brief Collects the resources that passes declare while they are set up,
+// and the passes that use them, so they can be allocated without executing
+// the FrameGraph (see TransientResources::preallocate). Includes those of the
+// passes that FrameGraph::compile would cull.
+class TransientDeclarationScope {
+  friend class PassBuilder;
+
+public:
+  explicit TransientDeclarationScope(TransientResources::Declarations &);
+  TransientDeclarationScope(const TransientDeclarationScope &) = delete;
+  TransientDeclarationScope(TransientDeclarationScope &&) noexcept = delete;
+  ~TransientDeclarationScope();
+
+  TransientDeclarationScope &
+  operator=(const TransientDeclarationScope &) = delete;
+  TransientDeclarationScope &
+  operator=(TransientDeclarationScope &&) noexcept = delete;
+
+private:
+  void _beginPass();
+  void _create(FrameGraphResource, const FrameGraphTexture::Desc &);
+  void _create(FrameGraphResource, const FrameGraphBuffer::Desc &);
+  // @param result Of builder.read/write (a write might create a new version).
+  void _access(FrameGraphResource id, FrameGraphResource result);
+
+private:
+  TransientResources::Declarations &m_declarations;
+  TransientDeclarationScope *m_previous;
+
+  uint32_t m_passIndex{0};
+  struct Entry {
+    bool isTexture;
+    std::size_t index; // In m_declarations.textures/buffers.
+  };
+  // Key = Any version of a created resource.
+  std::unordered_map<FrameGraphResource, Entry> m_entries;
+};
+
+// @brief FrameGraph::Builder that reports to the TransientDeclarationScope
+// (if any) of the calling thread.
+class PassBuilder {
+public:
+  explicit PassBuilder(FrameGraph::Builder &);
+  PassBuilder(const PassBuilder &) = delete;
+  PassBuilder(PassBuilder &&) noexcept = delete;
+  ~PassBuilder() = default;
+
+  PassBuilder &operator=(const PassBuilder &) = delete;
+  PassBuilder &operator=(PassBuilder &&) noexcept = delete;
+
+  template <typename T>
+  [[nodiscard]] FrameGraphResource create(const std::string_view name,
+                                          const typename T::Desc &);
+  FrameGraphResource read(FrameGraphResource id);
+  [[nodiscard]] FrameGraphResource write(FrameGraphResource id);
+  PassBuilder &setSideEffect();
+
+private:
+  FrameGraph::Builder &m_builder;
+  TransientDeclarationScope *m_scope;
+};
+
+// @brief FrameGraph::addCallbackPass, the setup gets a PassBuilder.
+template <typename Data = std::monostate, typename Setup, typename Execute>
+const Data &addCallbackPass(FrameGraph &fg, const std::string_view name,
+                            Setup &&setup, Execute &&exec) {
+  return fg.addCallbackPass<Data>(
+    name,
+    [&setup](FrameGraph::Builder &builder, Data &data) {
+      PassBuilder passBuilder{builder};
+      std::invoke(setup, passBuilder, data);
+    },
+    std::forward<Execute>(exec));
+}
+
+template <typename T>
+FrameGraphResource PassBuilder::create(const std::string_view name,
+                                       const typename T::Desc &desc) {
+  const auto id = m_builder.create<T>(name, desc);
+  if (m_scope) m_scope->_create(id, desc);
+  return id;
+}
@@ -1,4 +1,5 @@
 #include "Frustum.hpp"
+#include <utility>
 
 // https://www.lighthouse3d.com/tutorials/view-frustum-culling/
 
@@ -10,6 +11,26 @@ namespace {
   return plane.distanceTo(cone.T) < 0 && plane.distanceTo(Q) < 0;
 }
 
+// @return The vertices farthest along the plane normal and against it.
+[[nodiscard]] std::pair<glm::vec3, glm::vec3>
+getExtremeVertices(const AABB &aabb, const Plane &plane) {
+  auto pv = aabb.min;
+  auto nv = aabb.max;
+  if (plane.normal.x >= 0) {
+    pv.x = aabb.max.x;
+    nv.x = aabb.min.x;
+  }
+  if (plane.normal.y >= 0) {
+    pv.y = aabb.max.y;
+    nv.y = aabb.min.y;
+  }
+  if (plane.normal.z >= 0) {
+    pv.z = aabb.max.z;
+    nv.z = aabb.min.z;
+  }
+  return {pv, nv};
+}
+
 } // namespace
 
 enum FrustumSide {
@@ -20,7 +41,6 @@ enum FrustumSide {
   Near = 4, // Back
   Far = 5   // Front
 };
-enum class IntersectionResult { Outside, Intersect, Inside };
 
 //
 // Frustum class:
@@ -60,6 +80,8 @@ void Frustum::update(const glm::mat4 &m) {
     plane.normalize();
 }
 
+const std::array<Plane, 6> &Frustum::getPlanes() const { return m_planes; }
+
 bool Frustum::testPoint(const glm::vec3 &point) const {
   for (const auto &plane : m_planes)
     if (plane.distanceTo(point) < 0) return false; // Outside
@@ -89,22 +111,23 @@ bool Frustum::testCone(const Cone &cone) const {
 bool Frustum::testAABB(const AABB &aabb) const {
   auto result{IntersectionResult::Inside};
   for (const auto &plane : m_planes) {
-    auto pv = aabb.min;
-    auto nv = aabb.max;
-    if (plane.normal.x >= 0) {
-      pv.x = aabb.max.x;
-      nv.x = aabb.min.x;
-    }
-    if (plane.normal.y >= 0) {
-      pv.y = aabb.max.y;
-      nv.y = aabb.min.y;
-    }
-    if (plane.normal.z >= 0) {
-      pv.z = aabb.max.z;
-      nv.z = aabb.min.z;
-    }
+    const auto [pv, nv] = getExtremeVertices(aabb, plane);
     if (plane.distanceTo(pv) < 0) return false;
     if (plane.distanceTo(nv) < 0) result = IntersectionResult::Intersect;
   }
   return result != IntersectionResult::Outside;
 }
+IntersectionResult Frustum::testAABB(const AABB &aabb,
+                                     uint8_t &planeMask) const {
+  for (uint32_t i{0}; i < m_planes.size(); ++i) {
+    const auto bit = static_cast<uint8_t>(1u << i);
+    if (!(planeMask & bit)) continue;
+
+    const auto &plane = m_planes[i];
+    const auto [pv, nv] = getExtremeVertices(aabb, plane);
+    if (plane.distanceTo(pv) < 0) return IntersectionResult::Outside;
+    if (plane.distanceTo(nv) >= 0) planeMask &= ~bit; // Inside of this one.
+  }
+  return planeMask == 0 ? IntersectionResult::Inside
+                        : IntersectionResult::Intersect;
+}
@@ -6,15 +6,17 @@
 #include "Cone.hpp"
 #include <array>
 
+enum class IntersectionResult { Outside, Intersect, Inside };
+
 class Frustum final {
 public:
   Frustum() = default;
   explicit Frustum(const glm::mat4 &);
-  Frustum(const Frustum &) = delete;
+  Frustum(const Frustum &) = default;
   Frustum(Frustum &&) noexcept = default;
   ~Frustum() = default;
 
-  Frustum &operator=(const Frustum &) = delete;
+  Frustum &operator=(const Frustum &) = default;
   Frustum &operator=(Frustum &&) noexcept = default;
 
   /**
@@ -30,6 +32,18 @@ public:
   [[nodiscard]] bool testSphere(const Sphere &) const;
   [[nodiscard]] bool testCone(const Cone &) const;
 
+  [[nodiscard]] const std::array<Plane, 6> &getPlanes() const;
+
+  static constexpr uint8_t kAllPlanes{0b111111};
+  /**
+   * @brief For hierarchical culling, a box inside of its parent is inside of
+   * the planes that the parent is inside of (those are skipped).
+   * @param [in,out] planeMask Planes to test (bit per plane), on return the
+   * planes that the box straddles (0 = Inside).
+   */
+  [[nodiscard]] IntersectionResult testAABB(const AABB &,
+                                            uint8_t &planeMask) const;
+
 private:
   std::array<Plane, 6> m_planes;
 };
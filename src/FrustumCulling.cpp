@@ -0,0 +1,304 @@
+#include "FrustumCulling.hpp"
+#include "FrustumCullingKernels.hpp"
+#include "BVH.hpp"
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <cassert>
+
+#if defined(_M_X64) || defined(__x86_64__) || defined(_M_IX86) ||            \
+  defined(__i386__)
+#  define HAS_X86 1
+#  include <emmintrin.h>
+#  ifdef _MSC_VER
+#    include <intrin.h>
+#  endif
+#endif
+
+#ifdef HAS_X86
+namespace {
+
+// SSE2 is the baseline of x86-64, no target flags needed.
+struct SSELanes {
+  static constexpr std::size_t kWidth{4};
+  using Type = __m128;
+  using Mask = __m128;
+
+  static Type load(const float *p) { return _mm_loadu_ps(p); }
+  static Type broadcast(float v) { return _mm_set1_ps(v); }
+
+  static Type add(Type a, Type b) { return _mm_add_ps(a, b); }
+  static Type sub(Type a, Type b) { return _mm_sub_ps(a, b); }
+  static Type mul(Type a, Type b) { return _mm_mul_ps(a, b); }
+
+  static Mask none() { return _mm_setzero_ps(); }
+  static Mask less(Type a, Type b) { return _mm_cmplt_ps(a, b); }
+  static Mask maskOr(Mask a, Mask b) { return _mm_or_ps(a, b); }
+  static Mask maskAnd(Mask a, Mask b) { return _mm_and_ps(a, b); }
+  static uint32_t toBits(Mask m) {
+    return static_cast<uint32_t>(_mm_movemask_ps(m));
+  }
+};
+
+} // namespace
+#endif
+
+#include "FrustumCullingKernels.inl"
+
+namespace {
+
+[[nodiscard]] bool cpuSupportsAVX2() {
+#if defined(HAS_X86) && defined(_MSC_VER)
+  int32_t info[4];
+  __cpuid(info, 0);
+  if (info[0] < 7) return false;
+
+  __cpuid(info, 1);
+  constexpr auto kOSXSAVE = 1 << 27, kAVX = 1 << 28;
+  if ((info[2] & (kOSXSAVE | kAVX)) != (kOSXSAVE | kAVX)) return false;
+  // The OS saves the YMM registers.
+  if ((_xgetbv(0) & 0b110) != 0b110) return false;
+
+  __cpuidex(info, 7, 0);
+  return info[1] & (1 << 5);
+#elif defined(HAS_X86)
+  return __builtin_cpu_supports("avx2");
+#else
+  return false;
+#endif
+}
+
+[[nodiscard]] const CullingKernels &getKernels(SIMDLevel level) {
+  switch (level) {
+  case SIMDLevel::AVX2:
+    if (const auto *kernels = getAVX2CullingKernels(); kernels) {
+      return *kernels;
+    }
+    [[fallthrough]];
+  case SIMDLevel::SSE:
+#ifdef HAS_X86
+    return kCullingKernels<SSELanes>;
+#else
+    break;
+#endif
+  case SIMDLevel::Scalar:
+    break;
+  }
+  return kCullingKernels<ScalarLanes>;
+}
+
+[[nodiscard]] CullingPlanes toCullingPlanes(const Frustum &frustum) {
+  CullingPlanes planes;
+  const auto &src = frustum.getPlanes();
+  for (std::size_t i{0}; i < src.size(); ++i) {
+    planes.nx[i] = src[i].normal.x;
+    planes.ny[i] = src[i].normal.y;
+    planes.nz[i] = src[i].normal.z;
+    planes.d[i] = src[i].distance;
+  }
+  return planes;
+}
+[[nodiscard]] AABBsView toAABBsView(const AABBArray &aabbs) {
+  return {
+    .minX = aabbs.minX.data(),
+    .minY = aabbs.minY.data(),
+    .minZ = aabbs.minZ.data(),
+    .maxX = aabbs.maxX.data(),
+    .maxY = aabbs.maxY.data(),
+    .maxZ = aabbs.maxZ.data(),
+    .count = aabbs.size(),
+  };
+}
+
+} // namespace
+
+//
+// AABBArray struct:
+//
+
+void AABBArray::reserve(std::size_t n) {
+  for (auto *v : {&minX, &minY, &minZ, &maxX, &maxY, &maxZ})
+    v->reserve(n);
+}
+void AABBArray::push_back(const AABB &aabb) {
+  minX.push_back(aabb.min.x);
+  minY.push_back(aabb.min.y);
+  minZ.push_back(aabb.min.z);
+  maxX.push_back(aabb.max.x);
+  maxY.push_back(aabb.max.y);
+  maxZ.push_back(aabb.max.z);
+}
+void AABBArray::clear() {
+  for (auto *v : {&minX, &minY, &minZ, &maxX, &maxY, &maxZ})
+    v->clear();
+}
+std::size_t AABBArray::size() const { return minX.size(); }
+AABB AABBArray::getBounds() const {
+  if (size() == 0) return {};
+  return {
+    .min = {std::ranges::min(minX), std::ranges::min(minY),
+            std::ranges::min(minZ)},
+    .max = {std::ranges::max(maxX), std::ranges::max(maxY),
+            std::ranges::max(maxZ)},
+  };
+}
+
+//
+// SphereArray struct:
+//
+
+void SphereArray::reserve(std::size_t n) {
+  for (auto *v : {&x, &y, &z, &r})
+    v->reserve(n);
+}
+void SphereArray::push_back(const Sphere &sphere) {
+  x.push_back(sphere.c.x);
+  y.push_back(sphere.c.y);
+  z.push_back(sphere.c.z);
+  r.push_back(sphere.r);
+}
+std::size_t SphereArray::size() const { return x.size(); }
+
+//
+// ConeArray struct:
+//
+
+void ConeArray::reserve(std::size_t n) {
+  for (auto *v : {&tx, &ty, &tz, &dx, &dy, &dz, &h, &r})
+    v->reserve(n);
+}
+void ConeArray::push_back(const Cone &cone) {
+  tx.push_back(cone.T.x);
+  ty.push_back(cone.T.y);
+  tz.push_back(cone.T.z);
+  dx.push_back(cone.d.x);
+  dy.push_back(cone.d.y);
+  dz.push_back(cone.d.z);
+  h.push_back(cone.h);
+  r.push_back(cone.r);
+}
+std::size_t ConeArray::size() const { return tx.size(); }
+
+//
+// Culling:
+//
+
+const char *toString(SIMDLevel level) {
+  switch (level) {
+  case SIMDLevel::Scalar:
+    return "Scalar";
+  case SIMDLevel::SSE:
+    return "SSE";
+  case SIMDLevel::AVX2:
+    return "AVX2";
+  }
+  return "Unknown";
+}
+SIMDLevel getSIMDLevel() {
+  static const auto level = [] {
+    if (getAVX2CullingKernels() && cpuSupportsAVX2()) return SIMDLevel::AVX2;
+#ifdef HAS_X86
+    return SIMDLevel::SSE;
+#else
+    return SIMDLevel::Scalar;
+#endif
+  }();
+  return level;
+}
+
+std::size_t cullAABBs(const Frustum &frustum, const AABBArray &aabbs,
+                      uint32_t *out, SIMDLevel level) {
+  return getKernels(level).cullAABBs(toCullingPlanes(frustum),
+                                     toAABBsView(aabbs), out);
+}
+void cullAABBs(std::span<const Frustum> frusta, const AABBArray &aabbs,
+               uint8_t *masks, SIMDLevel level) {
+  assert(frusta.size() <= BVH::kMaxFrusta);
+  CullingPlanes planes[BVH::kMaxFrusta];
+  std::ranges::transform(frusta, planes, toCullingPlanes);
+  getKernels(level).cullAABBsMulti(planes, uint32_t(frusta.size()),
+                                   toAABBsView(aabbs), masks);
+}
+std::size_t cullSpheres(const Frustum &frustum, const SphereArray &spheres,
+                        uint32_t *out, SIMDLevel level) {
+  const SpheresView view{
+    .x = spheres.x.data(),
+    .y = spheres.y.data(),
+    .z = spheres.z.data(),
+    .r = spheres.r.data(),
+    .count = spheres.size(),
+  };
+  return getKernels(level).cullSpheres(toCullingPlanes(frustum), view, out);
+}
+std::size_t cullCones(const Frustum &frustum, const ConeArray &cones,
+                      uint32_t *out, SIMDLevel level) {
+  const ConesView view{
+    .tx = cones.tx.data(),
+    .ty = cones.ty.data(),
+    .tz = cones.tz.data(),
+    .dx = cones.dx.data(),
+    .dy = cones.dy.data(),
+    .dz = cones.dz.data(),
+    .h = cones.h.data(),
+    .r = cones.r.data(),
+    .count = cones.size(),
+  };
+  return getKernels(level).cullCones(toCullingPlanes(frustum), view, out);
+}
+
+std::pmr::vector<uint32_t>
+cullIndices(const Frustum &frustum, const AABBArray &aabbs, const BVH *bvh,
+            std::pmr::memory_resource *memoryResource) {
+  std::pmr::vector<uint32_t> result{memoryResource};
+  if (bvh) {
+    assert(bvh->getNumPrimitives() == aabbs.size());
+    // The BVH visits them out of order.
+    std::pmr::vector<uint8_t> visible(aabbs.size(), memoryResource);
+    bvh->cull(frustum, [&visible](uint32_t i) { visible[i] = 1; });
+    result.reserve(aabbs.size());
+    for (uint32_t i{0}; i < visible.size(); ++i)
+      if (visible[i]) result.push_back(i);
+  } else {
+    result.resize(aabbs.size());
+    result.resize(cullAABBs(frustum, aabbs, result.data()));
+  }
+  return result;
+}
+std::pmr::vector<uint8_t> cullMasks(std::span<const Frustum> frusta,
+                                    const AABBArray &aabbs, const BVH *bvh,
+                                    std::pmr::memory_resource *memoryResource) {
+  std::pmr::vector<uint8_t> masks(aabbs.size(), memoryResource);
+  if (bvh) {
+    assert(bvh->getNumPrimitives() == aabbs.size());
+    bvh->cull(frusta, [&masks](uint32_t i, uint8_t mask) { masks[i] = mask; });
+  } else {
+    cullAABBs(frusta, aabbs, masks.data());
+  }
+  return masks;
+}
+
+std::vector<CullingBenchmarkResult>
+benchmarkCulling(const Frustum &frustum, const AABBArray &aabbs,
+                 uint32_t numRuns) {
+  using clock = std::chrono::steady_clock;
+  assert(numRuns > 0);
+
+  std::vector<uint32_t> indices(aabbs.size());
+  std::vector<CullingBenchmarkResult> results;
+  for (auto level : {SIMDLevel::Scalar, SIMDLevel::SSE, SIMDLevel::AVX2}) {
+    if (level > getSIMDLevel()) break;
+
+    auto &result = results.emplace_back(CullingBenchmarkResult{
+      .level = level,
+      .time = std::numeric_limits<float>::max(),
+    });
+    for (auto i = 0u; i < numRuns; ++i) {
+      const auto beginTicks = clock::now();
+      result.numVisible = cullAABBs(frustum, aabbs, indices.data(), level);
+      const std::chrono::duration<float, std::milli> time{clock::now() -
+                                                          beginTicks};
+      result.time = std::min(result.time, time.count());
+    }
+  }
+  return results;
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include "Frustum.hpp"
+#include <memory_resource>
+#include <vector>
+#include <span>
+
+// Bounds as a structure of arrays, so the culling kernels test 4/8 of them
+// at once (see cullAABBs).
+struct AABBArray {
+  explicit AABBArray(std::pmr::memory_resource *memoryResource =
+                       std::pmr::get_default_resource())
+      : minX{memoryResource}, minY{memoryResource}, minZ{memoryResource},
+        maxX{memoryResource}, maxY{memoryResource}, maxZ{memoryResource} {}
+
+  void reserve(std::size_t);
+  void push_back(const AABB &);
+  void clear();
+  [[nodiscard]] std::size_t size() const;
+  // @return Of all the elements (a zero box if empty).
+  [[nodiscard]] AABB getBounds() const;
+
+  std::pmr::vector<float> minX, minY, minZ;
+  std::pmr::vector<float> maxX, maxY, maxZ;
+};
+struct SphereArray {
+  explicit SphereArray(std::pmr::memory_resource *memoryResource =
+                         std::pmr::get_default_resource())
+      : x{memoryResource}, y{memoryResource}, z{memoryResource},
+        r{memoryResource} {}
+
+  void reserve(std::size_t);
+  void push_back(const Sphere &);
+  [[nodiscard]] std::size_t size() const;
+
+  std::pmr::vector<float> x, y, z, r;
+};
+struct ConeArray {
+  explicit ConeArray(std::pmr::memory_resource *memoryResource =
+                       std::pmr::get_default_resource())
+      : tx{memoryResource}, ty{memoryResource}, tz{memoryResource},
+        dx{memoryResource}, dy{memoryResource}, dz{memoryResource},
+        h{memoryResource}, r{memoryResource} {}
+
+  void reserve(std::size_t);
+  void push_back(const Cone &);
+  [[nodiscard]] std::size_t size() const;
+
+  std::pmr::vector<float> tx, ty, tz;
+  std::pmr::vector<float> dx, dy, dz;
+  std::pmr::vector<float> h, r;
+};
+
+enum class SIMDLevel { Scalar, SSE, AVX2 };
+[[nodiscard]] const char *toString(SIMDLevel);
+// @return The widest level that both the build and the CPU support.
+[[nodiscard]] SIMDLevel getSIMDLevel();
+
+// The same results as the Frustum::test* functions, for every element.
+// @param out Indices of the visible elements (ascending), room for all.
+// @return Number of visible elements.
+
+[[nodiscard]] std::size_t cullAABBs(const Frustum &, const AABBArray &,
+                                    uint32_t *out,
+                                    SIMDLevel = getSIMDLevel());
+[[nodiscard]] std::size_t cullSpheres(const Frustum &, const SphereArray &,
+                                      uint32_t *out,
+                                      SIMDLevel = getSIMDLevel());
+[[nodiscard]] std::size_t cullCones(const Frustum &, const ConeArray &,
+                                    uint32_t *out,
+                                    SIMDLevel = getSIMDLevel());
+
+// @brief Tests every box (loaded once) against all of the frusta (8 at most).
+// @param masks Bit i of masks[j] is set if the box j is inside of the
+// frustum i, room for all.
+void cullAABBs(std::span<const Frustum>, const AABBArray &, uint8_t *masks,
+               SIMDLevel = getSIMDLevel());
+
+class BVH;
+// @param bvh Over the same bounds (nullptr = test all of them).
+// @return Indices of the elements inside of the frustum (ascending).
+[[nodiscard]] std::pmr::vector<uint32_t>
+cullIndices(const Frustum &, const AABBArray &, const BVH *bvh,
+            std::pmr::memory_resource *);
+// @param bvh Over the same bounds (nullptr = test all of them).
+// @return Mask per element (see cullAABBs), 0 = outside of all the frusta.
+[[nodiscard]] std::pmr::vector<uint8_t>
+cullMasks(std::span<const Frustum>, const AABBArray &, const BVH *bvh,
+          std::pmr::memory_resource *);
+
+struct CullingBenchmarkResult {
+  SIMDLevel level;
+  float time; // Best of the runs, in milliseconds.
+  std::size_t numVisible;
+};
+// @brief Times cullAABBs at every supported level (Scalar first).
+[[nodiscard]] std::vector<CullingBenchmarkResult>
+benchmarkCulling(const Frustum &, const AABBArray &, uint32_t numRuns);
@@ -0,0 +1,42 @@
+// Compiled with the AVX2 target flags (see CMakeLists.txt), selected at
+// runtime. Do not include anything but the kernels (see
+// FrustumCullingKernels.hpp).
+
+#include "FrustumCullingKernels.hpp"
+
+#if defined(__AVX2__)
+#  include <immintrin.h>
+
+namespace {
+
+struct AVX2Lanes {
+  static constexpr std::size_t kWidth{8};
+  using Type = __m256;
+  using Mask = __m256;
+
+  static Type load(const float *p) { return _mm256_loadu_ps(p); }
+  static Type broadcast(float v) { return _mm256_set1_ps(v); }
+
+  static Type add(Type a, Type b) { return _mm256_add_ps(a, b); }
+  static Type sub(Type a, Type b) { return _mm256_sub_ps(a, b); }
+  static Type mul(Type a, Type b) { return _mm256_mul_ps(a, b); }
+
+  static Mask none() { return _mm256_setzero_ps(); }
+  static Mask less(Type a, Type b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+  static Mask maskOr(Mask a, Mask b) { return _mm256_or_ps(a, b); }
+  static Mask maskAnd(Mask a, Mask b) { return _mm256_and_ps(a, b); }
+  static uint32_t toBits(Mask m) {
+    return static_cast<uint32_t>(_mm256_movemask_ps(m));
+  }
+};
+
+} // namespace
+
+#  include "FrustumCullingKernels.inl"
+
+const CullingKernels *getAVX2CullingKernels() {
+  return &kCullingKernels<AVX2Lanes>;
+}
+#else
+const CullingKernels *getAVX2CullingKernels() { return nullptr; }
+#endif
@@ -0,0 +1,46 @@
+#pragma once
+
+// Plain data only: shared with the translation units compiled with other
+// target flags (e.g. AVX2), an inline function from a header that they
+// include could be picked by the linker for the whole program.
+
+#include <cstddef>
+#include <cstdint>
+
+struct CullingPlanes {
+  float nx[6], ny[6], nz[6], d[6];
+};
+
+// Structure of arrays, count elements each.
+struct AABBsView {
+  const float *minX, *minY, *minZ;
+  const float *maxX, *maxY, *maxZ;
+  std::size_t count;
+};
+struct SpheresView {
+  const float *x, *y, *z, *r;
+  std::size_t count;
+};
+struct ConesView {
+  const float *tx, *ty, *tz; // Tip
+  const float *dx, *dy, *dz; // Direction
+  const float *h, *r;
+  std::size_t count;
+};
+
+// Each one writes the indices of the visible elements to out (in ascending
+// order, room for count of them) and returns their number.
+struct CullingKernels {
+  std::size_t (*cullAABBs)(const CullingPlanes &, const AABBsView &,
+                           uint32_t *out);
+  std::size_t (*cullSpheres)(const CullingPlanes &, const SpheresView &,
+                             uint32_t *out);
+  std::size_t (*cullCones)(const CullingPlanes &, const ConesView &,
+                           uint32_t *out);
+  // Bit f of masks[i] is set if the element i is inside of the frustum f.
+  void (*cullAABBsMulti)(const CullingPlanes *frusta, uint32_t numFrusta,
+                         const AABBsView &, uint8_t *masks);
+};
+
+// @return nullptr if the translation unit has not been compiled with AVX2.
+[[nodiscard]] const CullingKernels *getAVX2CullingKernels();
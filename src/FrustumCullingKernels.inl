@@ -0,0 +1,214 @@
+// Included by the translation units that implement the kernels, each one
+// with its own lanes type (and target flags), hence the internal linkage.
+
+namespace {
+
+struct ScalarLanes {
+  static constexpr std::size_t kWidth{1};
+  using Type = float;
+  using Mask = bool;
+
+  static Type load(const float *p) { return *p; }
+  static Type broadcast(float v) { return v; }
+
+  static Type add(Type a, Type b) { return a + b; }
+  static Type sub(Type a, Type b) { return a - b; }
+  static Type mul(Type a, Type b) { return a * b; }
+
+  static Mask none() { return false; }
+  static Mask less(Type a, Type b) { return a < b; }
+  static Mask maskOr(Mask a, Mask b) { return a || b; }
+  static Mask maskAnd(Mask a, Mask b) { return a && b; }
+  // @return Bit per lane.
+  static uint32_t toBits(Mask m) { return m ? 1u : 0u; }
+};
+
+template <typename V> struct Vec3 {
+  typename V::Type x, y, z;
+};
+template <typename V>
+[[nodiscard]] typename V::Type dot(const CullingPlanes &planes, uint32_t i,
+                                   const Vec3<V> &p) {
+  // The same order of operations as Plane::distanceTo (dot + distance).
+  return V::add(V::add(V::add(V::mul(V::broadcast(planes.nx[i]), p.x),
+                              V::mul(V::broadcast(planes.ny[i]), p.y)),
+                       V::mul(V::broadcast(planes.nz[i]), p.z)),
+                V::broadcast(planes.d[i]));
+}
+template <typename V>
+[[nodiscard]] Vec3<V> cross(const Vec3<V> &a, const Vec3<V> &b) {
+  return {
+    V::sub(V::mul(a.y, b.z), V::mul(a.z, b.y)),
+    V::sub(V::mul(a.z, b.x), V::mul(a.x, b.z)),
+    V::sub(V::mul(a.x, b.y), V::mul(a.y, b.x)),
+  };
+}
+
+// Branchless compaction (most of the elements are visible, or none).
+template <typename V>
+std::size_t emit(uint32_t visibleBits, std::size_t first, uint32_t *out) {
+  std::size_t count{0};
+  for (std::size_t lane{0}; lane < V::kWidth; ++lane) {
+    out[count] = static_cast<uint32_t>(first + lane);
+    count += (visibleBits >> lane) & 1u;
+  }
+  return count;
+}
+
+template <typename V> struct Box {
+  Vec3<V> min, max;
+};
+template <typename V>
+[[nodiscard]] Box<V> loadAABBs(const AABBsView &aabbs, std::size_t i) {
+  return {
+    .min = {V::load(aabbs.minX + i), V::load(aabbs.minY + i),
+            V::load(aabbs.minZ + i)},
+    .max = {V::load(aabbs.maxX + i), V::load(aabbs.maxY + i),
+            V::load(aabbs.maxZ + i)},
+  };
+}
+
+// Frustum::testAABB: outside of a plane if the positive vertex is.
+template <typename V>
+[[nodiscard]] typename V::Mask isAABBOutside(const CullingPlanes &planes,
+                                             const Box<V> &box) {
+  auto outside = V::none();
+  for (uint32_t p{0}; p < 6; ++p) {
+    const Vec3<V> pv{
+      planes.nx[p] >= 0 ? box.max.x : box.min.x,
+      planes.ny[p] >= 0 ? box.max.y : box.min.y,
+      planes.nz[p] >= 0 ? box.max.z : box.min.z,
+    };
+    outside =
+      V::maskOr(outside, V::less(dot(planes, p, pv), V::broadcast(0.0f)));
+  }
+  return outside;
+}
+// Frustum::testSphere.
+template <typename V>
+[[nodiscard]] typename V::Mask isSphereOutside(const CullingPlanes &planes,
+                                               const SpheresView &spheres,
+                                               std::size_t i) {
+  const Vec3<V> c{
+    V::load(spheres.x + i),
+    V::load(spheres.y + i),
+    V::load(spheres.z + i),
+  };
+  const auto negativeRadius =
+    V::sub(V::broadcast(0.0f), V::load(spheres.r + i));
+  auto outside = V::none();
+  for (uint32_t p{0}; p < 6; ++p)
+    outside = V::maskOr(outside, V::less(dot(planes, p, c), negativeRadius));
+  return outside;
+}
+// Frustum::testCone: outside if both the tip and the base point closest to
+// the plane are behind it.
+template <typename V>
+[[nodiscard]] typename V::Mask isConeOutside(const CullingPlanes &planes,
+                                             const ConesView &cones,
+                                             std::size_t i) {
+  const Vec3<V> T{
+    V::load(cones.tx + i),
+    V::load(cones.ty + i),
+    V::load(cones.tz + i),
+  };
+  const Vec3<V> d{
+    V::load(cones.dx + i),
+    V::load(cones.dy + i),
+    V::load(cones.dz + i),
+  };
+  const auto h = V::load(cones.h + i);
+  const auto r = V::load(cones.r + i);
+  const auto zero = V::broadcast(0.0f);
+
+  auto outside = V::none();
+  for (uint32_t p{0}; p < 6; ++p) {
+    const Vec3<V> n{
+      V::broadcast(planes.nx[p]),
+      V::broadcast(planes.ny[p]),
+      V::broadcast(planes.nz[p]),
+    };
+    const auto m = cross<V>(cross<V>(n, d), d);
+    const Vec3<V> Q{
+      V::sub(V::add(T.x, V::mul(d.x, h)), V::mul(m.x, r)),
+      V::sub(V::add(T.y, V::mul(d.y, h)), V::mul(m.y, r)),
+      V::sub(V::add(T.z, V::mul(d.z, h)), V::mul(m.z, r)),
+    };
+    outside = V::maskOr(outside, V::maskAnd(V::less(dot(planes, p, T), zero),
+                                            V::less(dot(planes, p, Q), zero)));
+  }
+  return outside;
+}
+
+// Full vectors of V, then the remainder one by one.
+template <typename V, typename View, typename Func>
+std::size_t cull(const View &view, uint32_t *out, Func isOutside) {
+  constexpr auto kAllLanes = (1u << V::kWidth) - 1u;
+  std::size_t count{0};
+  std::size_t i{0};
+  for (; i + V::kWidth <= view.count; i += V::kWidth) {
+    const auto outsideBits = V::toBits(isOutside.template operator()<V>(i));
+    count += emit<V>(~outsideBits & kAllLanes, i, out + count);
+  }
+  for (; i < view.count; ++i) {
+    const auto outsideBits =
+      ScalarLanes::toBits(isOutside.template operator()<ScalarLanes>(i));
+    count += emit<ScalarLanes>(~outsideBits & 1u, i, out + count);
+  }
+  return count;
+}
+
+template <typename V>
+std::size_t cullAABBs(const CullingPlanes &planes, const AABBsView &aabbs,
+                      uint32_t *out) {
+  return cull<V>(aabbs, out, [&]<typename L>(std::size_t i) {
+    return isAABBOutside<L>(planes, loadAABBs<L>(aabbs, i));
+  });
+}
+// Every box is loaded once, and tested against all of the frusta.
+template <typename V>
+void cullAABBsMulti(const CullingPlanes *frusta, uint32_t numFrusta,
+                    const AABBsView &aabbs, uint8_t *masks) {
+  const auto cullBlock = [&]<typename L>(std::size_t i) {
+    constexpr auto kAllLanes = (1u << L::kWidth) - 1u;
+    const auto box = loadAABBs<L>(aabbs, i);
+    uint8_t blockMasks[L::kWidth]{};
+    for (uint32_t f{0}; f < numFrusta; ++f) {
+      const auto insideBits =
+        ~L::toBits(isAABBOutside<L>(frusta[f], box)) & kAllLanes;
+      for (std::size_t lane{0}; lane < L::kWidth; ++lane)
+        blockMasks[lane] |= ((insideBits >> lane) & 1u) << f;
+    }
+    for (std::size_t lane{0}; lane < L::kWidth; ++lane)
+      masks[i + lane] = blockMasks[lane];
+  };
+
+  std::size_t i{0};
+  for (; i + V::kWidth <= aabbs.count; i += V::kWidth)
+    cullBlock.template operator()<V>(i);
+  for (; i < aabbs.count; ++i)
+    cullBlock.template operator()<ScalarLanes>(i);
+}
+template <typename V>
+std::size_t cullSpheres(const CullingPlanes &planes,
+                        const SpheresView &spheres, uint32_t *out) {
+  return cull<V>(spheres, out, [&]<typename L>(std::size_t i) {
+    return isSphereOutside<L>(planes, spheres, i);
+  });
+}
+template <typename V>
+std::size_t cullCones(const CullingPlanes &planes, const ConesView &cones,
+                      uint32_t *out) {
+  return cull<V>(cones, out, [&]<typename L>(std::size_t i) {
+    return isConeOutside<L>(planes, cones, i);
+  });
+}
+
+template <typename V> constexpr CullingKernels kCullingKernels{
+  .cullAABBs = cullAABBs<V>,
+  .cullSpheres = cullSpheres<V>,
+  .cullCones = cullCones<V>,
+  .cullAABBsMulti = cullAABBsMulti<V>,
+};
+
+} // namespace
@@ -0,0 +1,124 @@
+#include "GPUProfiler.hpp"
+#include <algorithm>
+#include <cassert>
+
+//
+// GPUProfiler class:
+//
+
+GPUProfiler::~GPUProfiler() {
+  for (auto &frame : m_frames)
+    glDeleteQueries(static_cast<GLsizei>(frame.queries.size()),
+                    frame.queries.data());
+}
+
+void GPUProfiler::beginScope(const std::string_view name) {
+  auto &frame = m_frames[m_frameIndex];
+  m_openScopes.push_back(static_cast<uint32_t>(frame.scopes.size()));
+  frame.scopes.push_back({
+    .name = std::string{name},
+    .depth = static_cast<uint32_t>(m_openScopes.size() - 1),
+    .beginQuery = _writeTimestamp(frame),
+  });
+}
+void GPUProfiler::endScope() {
+  assert(!m_openScopes.empty());
+  auto &frame = m_frames[m_frameIndex];
+  frame.scopes[m_openScopes.back()].endQuery = _writeTimestamp(frame);
+  m_openScopes.pop_back();
+}
+
+void GPUProfiler::endFrame() {
+  assert(m_openScopes.empty());
+  m_frameIndex = (m_frameIndex + 1) % kNumFrames;
+  // The oldest frame, issued kNumFrames - 1 frames ago.
+  _resolve(m_frames[m_frameIndex]);
+}
+
+std::span<const GPUProfiler::ScopeTiming> GPUProfiler::getTimings() const {
+  return m_timings;
+}
+std::optional<GPUProfiler::Timing>
+GPUProfiler::getTiming(const std::string_view name) const {
+  if (const auto it = m_histories.find(name); it != m_histories.cend())
+    return it->second.timing;
+  return std::nullopt;
+}
+
+uint64_t GPUProfiler::getNumDroppedFrames() const {
+  return m_numDroppedFrames;
+}
+
+uint32_t GPUProfiler::_writeTimestamp(Frame &frame) {
+  if (frame.numUsedQueries == frame.queries.size()) {
+    GLuint query;
+    glCreateQueries(GL_TIMESTAMP, 1, &query);
+    frame.queries.push_back(query);
+  }
+  const auto index = frame.numUsedQueries++;
+  glQueryCounter(frame.queries[index], GL_TIMESTAMP);
+  return index;
+}
+
+void GPUProfiler::_resolve(Frame &frame) {
+  if (frame.scopes.empty()) return;
+
+  // Queries complete in order, checking the last one is enough.
+  GLint available{GL_FALSE};
+  glGetQueryObjectiv(frame.queries[frame.numUsedQueries - 1],
+                     GL_QUERY_RESULT_AVAILABLE, &available);
+  if (available == GL_FALSE) {
+    ++m_numDroppedFrames;
+  } else {
+    std::vector<GLuint64> timestamps(frame.numUsedQueries);
+    for (uint32_t i{0}; i < frame.numUsedQueries; ++i)
+      glGetQueryObjectui64v(frame.queries[i], GL_QUERY_RESULT, &timestamps[i]);
+
+    // Sum up scopes with the same name (e.g. a pass executed per cascade).
+    struct Sample {
+      const Scope *scope;
+      float duration; // In milliseconds.
+    };
+    std::vector<Sample> samples;
+    for (const auto &scope : frame.scopes) {
+      const auto duration =
+        static_cast<float>(timestamps[scope.endQuery] -
+                           timestamps[scope.beginQuery]) /
+        1'000'000.0f;
+      const auto it = std::ranges::find_if(samples, [&scope](const auto &s) {
+        return s.scope->name == scope.name;
+      });
+      if (it != samples.end())
+        it->duration += duration;
+      else
+        samples.push_back({&scope, duration});
+    }
+
+    m_timings.clear();
+    for (const auto &[scope, duration] : samples) {
+      auto &[key, history] = *m_histories.try_emplace(scope->name).first;
+      history.samples[history.head] = duration;
+      history.head = (history.head + 1) % kWindowSize;
+      history.numSamples = std::min(history.numSamples + 1, kWindowSize);
+
+      const auto window = std::span{history.samples}.first(history.numSamples);
+      const auto [min, max] = std::ranges::minmax(window);
+      float sum{0.0f};
+      for (const auto v : window)
+        sum += v;
+      history.timing = {
+        .last = duration,
+        .average = sum / static_cast<float>(history.numSamples),
+        .min = min,
+        .max = max,
+      };
+      m_timings.push_back({
+        .name = key,
+        .depth = scope->depth,
+        .timing = history.timing,
+      });
+    }
+  }
+  frame.numUsedQueries = 0;
+  frame.scopes.clear();
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "glad/gl.h"
+#include "Hash.hpp"
+#include <array>
+#include <optional>
+#include <vector>
+#include <span>
+#include <string>
+#include <unordered_map>
+
+// @brief Measures GPU time of (nested) scopes with GL_TIMESTAMP queries.
+// Queries of a frame are read back kNumFrames later, hence it never waits for
+// the GPU (a frame that is still not ready by then is dropped).
+class GPUProfiler {
+public:
+  GPUProfiler() = default;
+  GPUProfiler(const GPUProfiler &) = delete;
+  GPUProfiler(GPUProfiler &&) noexcept = delete;
+  ~GPUProfiler();
+
+  GPUProfiler &operator=(const GPUProfiler &) = delete;
+  GPUProfiler &operator=(GPUProfiler &&) noexcept = delete;
+
+  void beginScope(const std::string_view name);
+  void endScope();
+
+  // Reads back the oldest frame (if available) and starts a new one.
+  void endFrame();
+
+  struct Timing {
+    float last{0.0f}; // All values in milliseconds.
+    float average{0.0f};
+    float min{0.0f};
+    float max{0.0f};
+  };
+  struct ScopeTiming {
+    std::string_view name;
+    uint32_t depth{0}; // Nesting level.
+    Timing timing;
+  };
+  // @return Scopes of the last resolved frame (in submission order), scopes
+  // with the same name are summed up.
+  [[nodiscard]] std::span<const ScopeTiming> getTimings() const;
+  [[nodiscard]] std::optional<Timing> getTiming(const std::string_view) const;
+
+  [[nodiscard]] uint64_t getNumDroppedFrames() const;
+
+private:
+  static constexpr uint32_t kNumFrames{4};
+  // Number of samples the rolling stats are computed from.
+  static constexpr uint32_t kWindowSize{64};
+
+  struct Scope {
+    std::string name;
+    uint32_t depth{0};
+    uint32_t beginQuery{0};
+    uint32_t endQuery{0};
+  };
+  struct Frame {
+    std::vector<GLuint> queries; // Pool, grows on demand.
+    uint32_t numUsedQueries{0};
+    std::vector<Scope> scopes;
+  };
+
+  [[nodiscard]] uint32_t _writeTimestamp(Frame &);
+  void _resolve(Frame &);
+
+private:
+  std::array<Frame, kNumFrames> m_frames;
+  uint32_t m_frameIndex{0};
+  std::vector<uint32_t> m_openScopes; // Indices into Frame::scopes.
+
+  struct History {
+    std::array<float, kWindowSize> samples{};
+    uint32_t numSamples{0};
+    uint32_t head{0};
+    Timing timing;
+  };
+  std::unordered_map<std::string, History, StringHash, std::equal_to<>>
+    m_histories;
+  std::vector<ScopeTiming> m_timings;
+  uint64_t m_numDroppedFrames{0};
+};
@@ -14,6 +14,9 @@
 
 #include "tracy/TracyOpenGL.hpp"
 
+#include <memory>
+#include <cassert>
+
 namespace {
 
 constexpr auto kRSMResolution = 512;
@@ -39,8 +42,9 @@ Grid::Grid(const AABB &_aabb) : aabb{_aabb} {
 // GlobalIllumination class:
 //
 
-GlobalIllumination::GlobalIllumination(RenderContext &rc)
-    : BaseGeometryPass{rc} {
+GlobalIllumination::GlobalIllumination(RenderContext &rc,
+                                       JobSystem &jobSystem)
+    : BaseGeometryPass{rc, jobSystem} {
   constexpr auto kAdditiveBlending = BlendState{
     .enabled = true,
     .srcColor = BlendFactor::One,
@@ -112,23 +116,31 @@ GlobalIllumination::~GlobalIllumination() {
     .destroy(m_debugPipeline);
 }
 
-void GlobalIllumination::update(
-  FrameGraph &fg, FrameGraphBlackboard &blackboard, const Grid &grid,
-  const PerspectiveCamera &camera, const Light &light,
-  std::span<const Renderable> renderables, uint32_t numPropagations) {
-
-  auto lightView =
+void GlobalIllumination::update(const PerspectiveCamera &camera,
+                                const Light &light,
+                                std::pmr::memory_resource *memoryResource) {
+  // The list takes the allocator of the given resource (once, it does not
+  // change between frames), so setRenderables takes over the storage.
+  if (m_renderables.get_allocator().resource() != memoryResource) {
+    std::destroy_at(&m_renderables);
+    std::construct_at(&m_renderables, memoryResource);
+  }
+  m_lightViewProjection =
     buildCascades(camera, light.direction, 1, 1.0f, kRSMResolution)[0]
       .viewProjMatrix;
-
-  std::vector<const Renderable *> visibleRenderables(renderables.size());
-  std::transform(renderables.begin(), renderables.end(),
-                 visibleRenderables.begin(),
-                 [](const Renderable &r) { return std::addressof(r); });
-
-  const auto RSM = _addReflectiveShadowMapPass(fg, std::move(lightView),
-                                               light.color * light.intensity,
-                                               std::move(visibleRenderables));
+  m_lightIntensity = light.color * light.intensity;
+}
+const glm::mat4 &GlobalIllumination::getLightViewProjection() const {
+  return m_lightViewProjection;
+}
+void GlobalIllumination::setRenderables(RenderableList &&renderables) {
+  assert(renderables.get_allocator() == m_renderables.get_allocator());
+  m_renderables = std::move(renderables);
+}
+void GlobalIllumination::addPasses(FrameGraph &fg,
+                                   FrameGraphBlackboard &blackboard,
+                                   const Grid &grid, uint32_t numPropagations) {
+  const auto RSM = _addReflectiveShadowMapPass(fg);
   blackboard.add<ReflectiveShadowMapData>(RSM);
 
   const auto radiance = _addRadianceInjectionPass(fg, RSM, grid);
@@ -147,9 +159,9 @@ FrameGraphResource GlobalIllumination::addDebugPass(
   const auto &RSM = blackboard.get<ReflectiveShadowMapData>();
   const auto &LPV = blackboard.get<LightPropagationVolumesData>();
 
-  fg.addCallbackPass(
-    "DebugVPL",
-    [&](FrameGraph::Builder &builder, auto &) {
+  addCallbackPass(
+    fg, "DebugVPL",
+    [&](PassBuilder &builder, auto &) {
       builder.read(gBuffer.depth);
 
       builder.read(RSM.position);
@@ -161,8 +173,8 @@ FrameGraphResource GlobalIllumination::addDebugPass(
 
       target = builder.write(target);
     },
-    [=, this, vp = camera.getViewProjection()](
-      const auto &, FrameGraphPassResources &resources, void *ctx) {
+    [=, this, camera = &camera](const auto &,
+                                FrameGraphPassResources &resources, void *ctx) {
       NAMED_DEBUG_MARKER("DebugVPL");
       TracyGpuZone("DebugVPL");
 
@@ -188,11 +200,11 @@ FrameGraphResource GlobalIllumination::addDebugPass(
         .bindTexture(3, getTexture(resources, LPV.g)) // frag
         .bindTexture(4, getTexture(resources, LPV.b)) // frag
 
-        .setUniform1i("u_RSMResolution", kRSMResolution) // vert
-        .setUniformVec3("u_MinCorner", grid.aabb.min)    // vert
-        .setUniformVec3("u_GridSize", grid.size)         // vert/frag
-        .setUniform1f("u_CellSize", grid.cellSize)       // vert/frag
-        .setUniformMat4("u_VP", vp)                      // vert
+        .setUniform1i("u_RSMResolution", kRSMResolution)     // vert
+        .setUniformVec3("u_MinCorner", grid.aabb.min)        // vert
+        .setUniformVec3("u_GridSize", grid.size)             // vert/frag
+        .setUniform1f("u_CellSize", grid.cellSize)           // vert/frag
+        .setUniformMat4("u_VP", camera->getViewProjection()) // vert
 
         .draw(std::nullopt, std::nullopt,
               GeometryInfo{
@@ -205,14 +217,13 @@ FrameGraphResource GlobalIllumination::addDebugPass(
   return target;
 }
 
-ReflectiveShadowMapData GlobalIllumination::_addReflectiveShadowMapPass(
-  FrameGraph &fg, const glm::mat4 &lightViewProjection,
-  glm::vec3 lightIntensity, std::vector<const Renderable *> &&renderables) {
+ReflectiveShadowMapData
+GlobalIllumination::_addReflectiveShadowMapPass(FrameGraph &fg) {
   constexpr auto kExtent = Extent2D{kRSMResolution, kRSMResolution};
 
-  const auto data = fg.addCallbackPass<ReflectiveShadowMapData>(
-    "ReflectiveShadowMap",
-    [&](FrameGraph::Builder &builder, ReflectiveShadowMapData &data) {
+  const auto data = addCallbackPass<ReflectiveShadowMapData>(
+    fg, "ReflectiveShadowMap",
+    [&](PassBuilder &builder, ReflectiveShadowMapData &data) {
       data.depth = builder.create<FrameGraphTexture>(
         "RSM/Depth", {
                        .extent = kExtent,
@@ -246,9 +257,8 @@ ReflectiveShadowMapData GlobalIllumination::_addReflectiveShadowMapPass(
       data.normal = builder.write(data.normal);
       data.flux = builder.write(data.flux);
     },
-    [=, this, renderables = std::move(renderables)](
-      const ReflectiveShadowMapData &data, FrameGraphPassResources &resources,
-      void *ctx) {
+    [=, this](const ReflectiveShadowMapData &data,
+              FrameGraphPassResources &resources, void *ctx) {
       NAMED_DEBUG_MARKER("ReflectiveShadowMap");
       TracyGpuZone("ReflectiveShadowMap");
 
@@ -281,21 +291,11 @@ ReflectiveShadowMapData GlobalIllumination::_addReflectiveShadowMapPass(
       };
       auto &rc = *static_cast<RenderContext *>(ctx);
       const auto framebuffer = rc.beginRendering(renderingInfo);
-      for (const auto *renderable : renderables) {
-        const auto &[mesh, subMeshId, material, flags, modelMatrix, _1] =
-          *renderable;
-
-        rc.setGraphicsPipeline(_getPipeline(*mesh.vertexFormat, &material));
-        _setTransform(lightViewProjection, modelMatrix);
-
-        for (uint32_t unit{kFirstFreeTextureBinding};
-             const auto &[_, texture] : material.getDefaultTextures()) {
-          rc.bindTexture(unit++, *texture);
-        }
-        rc.setUniformVec3("u_LightIntensity", lightIntensity) // frag
-          .draw(*mesh.vertexBuffer, *mesh.indexBuffer,
-                mesh.subMeshes[subMeshId].geometryInfo);
-      }
+      const auto setLightIntensity = [this, &rc] {
+        rc.setUniformVec3("u_LightIntensity", m_lightIntensity); // frag
+      };
+      _drawRenderables(m_renderables, m_lightViewProjection,
+                       kFirstFreeTextureBinding, setLightIntensity);
       rc.endRendering(framebuffer);
     });
 
@@ -306,9 +306,9 @@ LightPropagationVolumesData GlobalIllumination::_addRadianceInjectionPass(
   FrameGraph &fg, const ReflectiveShadowMapData &RSM, const Grid &grid) {
   const auto extent = Extent2D{.width = grid.size.x, .height = grid.size.y};
 
-  const auto data = fg.addCallbackPass<LightPropagationVolumesData>(
-    "RadianceInjection",
-    [&](FrameGraph::Builder &builder, LightPropagationVolumesData &data) {
+  const auto data = addCallbackPass<LightPropagationVolumesData>(
+    fg, "RadianceInjection",
+    [&](PassBuilder &builder, LightPropagationVolumesData &data) {
       builder.read(RSM.position);
       builder.read(RSM.normal);
       builder.read(RSM.flux);
@@ -398,9 +398,9 @@ LightPropagationVolumesData GlobalIllumination::_addRadiancePropagationPass(
   const auto name = "RadiancePropagation #" + std::to_string(iteration);
   const auto extent = Extent2D{.width = grid.size.x, .height = grid.size.y};
 
-  const auto data = fg.addCallbackPass<LightPropagationVolumesData>(
-    name,
-    [&](FrameGraph::Builder &builder, LightPropagationVolumesData &data) {
+  const auto data = addCallbackPass<LightPropagationVolumesData>(
+    fg, name,
+    [&](PassBuilder &builder, LightPropagationVolumesData &data) {
       builder.read(LPV.r);
       builder.read(LPV.g);
       builder.read(LPV.b);
@@ -490,7 +490,8 @@ GlobalIllumination::_createBasePassPipeline(const VertexFormat &vertexFormat,
   const auto vao = m_renderContext.getVertexArray(vertexFormat.getAttributes());
 
   ShaderCodeBuilder shaderCodeBuilder;
-  shaderCodeBuilder.setDefines(buildDefines(vertexFormat));
+  shaderCodeBuilder.setDefines(buildDefines(vertexFormat))
+    .addDefine("MULTI_DRAW", 1);
 
   const auto vertCode =
     shaderCodeBuilder.replace("#pragma USER_CODE", material->getUserVertCode())
@@ -505,7 +506,7 @@ GlobalIllumination::_createBasePassPipeline(const VertexFormat &vertexFormat,
       .build("ReflectiveShadowMapPass.frag");
 
   const auto program =
-    m_renderContext.createGraphicsProgram(vertCode, fragCode);
+    m_renderContext.createGraphicsProgramAsync(vertCode, fragCode);
 
   return GraphicsPipeline::Builder{}
     .setDepthStencil({
@@ -6,25 +6,33 @@
 #include "ReflectiveShadowMapData.hpp"
 #include "LightPropagationVolumesData.hpp"
 #include "Grid.hpp"
-#include <span>
+#include <memory_resource>
 
 class GlobalIllumination final : public BaseGeometryPass {
 public:
-  explicit GlobalIllumination(RenderContext &);
+  GlobalIllumination(RenderContext &, JobSystem &);
   ~GlobalIllumination();
 
-  void update(FrameGraph &, FrameGraphBlackboard &, const Grid &,
-              const PerspectiveCamera &, const Light &,
-              std::span<const Renderable>, uint32_t numPropagations);
+  // @brief Sets up the light view for the passes added by addPasses (read
+  // when the FrameGraph executes).
+  // @param memoryResource Per-frame, the list passed to setRenderables must
+  // be allocated from it.
+  void update(const PerspectiveCamera &, const Light &,
+              std::pmr::memory_resource *);
+  // @return Of the reflective shadow map, valid after the update.
+  [[nodiscard]] const glm::mat4 &getLightViewProjection() const;
+  // @param renderables Inside of the light view (see getLightViewProjection).
+  void setRenderables(RenderableList &&renderables);
+  void addPasses(FrameGraph &, FrameGraphBlackboard &, const Grid &,
+                 uint32_t numPropagations);
 
   [[nodiscard]] FrameGraphResource
   addDebugPass(FrameGraph &, FrameGraphBlackboard &, const Grid &,
                const PerspectiveCamera &, FrameGraphResource target);
 
 private:
-  [[nodiscard]] ReflectiveShadowMapData _addReflectiveShadowMapPass(
-    FrameGraph &, const glm::mat4 &lightViewProjection,
-    glm::vec3 lightIntensity, std::vector<const Renderable *> &&);
+  [[nodiscard]] ReflectiveShadowMapData
+  _addReflectiveShadowMapPass(FrameGraph &);
 
   [[nodiscard]] LightPropagationVolumesData
   _addRadianceInjectionPass(FrameGraph &, const ReflectiveShadowMapData &,
@@ -41,4 +49,8 @@ private:
   GraphicsPipeline m_radiancePropagationPipeline;
 
   GraphicsPipeline m_debugPipeline;
+
+  glm::mat4 m_lightViewProjection{1.0f};
+  glm::vec3 m_lightIntensity{0.0f};
+  RenderableList m_renderables;
 };
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <functional>
+#include <string_view>
 
 template <typename T, typename... Rest>
 static inline void hashCombine(std::size_t &seed, const T &v,
@@ -9,3 +10,12 @@ static inline void hashCombine(std::size_t &seed, const T &v,
   seed ^= std::hash<T>{}(v) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
   (hashCombine(seed, rest), ...);
 }
+
+// Enables heterogeneous lookup (std::string keys, std::string_view queries).
+struct StringHash {
+  using is_transparent = void;
+
+  std::size_t operator()(std::string_view str) const noexcept {
+    return std::hash<std::string_view>{}(str);
+  }
+};
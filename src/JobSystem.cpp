@@ -0,0 +1,184 @@
+#include "JobSystem.hpp"
+#include "tracy/Tracy.hpp"
+#include <algorithm>
+
+namespace {
+
+// Index of the queue that the current thread pushes to (and pops from).
+thread_local uint32_t tl_queueIndex{0};
+
+} // namespace
+
+struct JobSystem::Job {
+  std::function<void()> function;
+  // Unfinished dependencies (+1 until the job is fully scheduled).
+  std::atomic<uint32_t> numPending{1};
+
+  std::mutex mutex; // Guards the following:
+  bool finished{false};
+  std::vector<JobHandle> dependents;
+
+  std::atomic<bool> done{false};
+};
+
+//
+// JobSystem class:
+//
+
+JobSystem::JobSystem(uint32_t numThreads) {
+  m_queues.resize(numThreads + 1);
+  for (auto &queue : m_queues)
+    queue = std::make_unique<Queue>();
+
+  m_threads.reserve(numThreads);
+  for (auto i = 1u; i <= numThreads; ++i)
+    m_threads.emplace_back(&JobSystem::_workerLoop, this, i);
+}
+JobSystem::~JobSystem() {
+  {
+    std::lock_guard lock{m_sleepMutex};
+    m_stop = true;
+  }
+  m_wakeUp.notify_all();
+  for (auto &thread : m_threads)
+    thread.join();
+}
+
+JobSystem::JobHandle
+JobSystem::schedule(std::function<void()> function,
+                    std::initializer_list<JobHandle> dependencies) {
+  return _schedule(std::move(function),
+                   {dependencies.begin(), dependencies.size()});
+}
+JobSystem::JobHandle
+JobSystem::scheduleParallelFor(std::size_t count, std::size_t grainSize,
+                               RangeFunction function,
+                               std::initializer_list<JobHandle> dependencies) {
+  grainSize = std::max<std::size_t>(grainSize, 1);
+  const auto numRanges = std::min<std::size_t>(
+    (count + grainSize - 1) / grainSize, getNumThreads() + 1);
+  if (numRanges == 0) return schedule([] {}, dependencies);
+
+  const auto rangeSize = (count + numRanges - 1) / numRanges;
+  auto sharedFunction = std::make_shared<RangeFunction>(std::move(function));
+  std::vector<JobHandle> ranges;
+  ranges.reserve(numRanges);
+  for (std::size_t first{0}; first < count; first += rangeSize) {
+    ranges.push_back(schedule(
+      [sharedFunction, first, last = std::min(first + rangeSize, count)] {
+        (*sharedFunction)(first, last);
+      },
+      dependencies));
+  }
+  return ranges.size() == 1 ? ranges.front() : _schedule([] {}, ranges);
+}
+void JobSystem::parallelFor(std::size_t count, std::size_t grainSize,
+                            RangeFunction function) {
+  wait(scheduleParallelFor(count, grainSize, std::move(function)));
+}
+
+void JobSystem::wait(const JobHandle &job) {
+  while (job && !job->done.load(std::memory_order_acquire)) {
+    if (auto next = _pop()) {
+      _execute(next);
+    } else {
+      std::this_thread::yield();
+    }
+  }
+}
+
+uint32_t JobSystem::getNumThreads() const {
+  return static_cast<uint32_t>(m_threads.size());
+}
+uint32_t JobSystem::getDefaultNumThreads() {
+  return std::max(std::thread::hardware_concurrency(), 1u) - 1;
+}
+
+JobSystem::JobHandle
+JobSystem::_schedule(std::function<void()> function,
+                     std::span<const JobHandle> dependencies) {
+  auto job = std::make_shared<Job>();
+  job->function = std::move(function);
+  for (const auto &dependency : dependencies) {
+    if (!dependency) continue;
+
+    std::lock_guard lock{dependency->mutex};
+    if (!dependency->finished) {
+      job->numPending.fetch_add(1);
+      dependency->dependents.push_back(job);
+    }
+  }
+  if (job->numPending.fetch_sub(1) == 1) _enqueue(job);
+  return job;
+}
+
+void JobSystem::_enqueue(JobHandle job) {
+  const auto queueIndex = tl_queueIndex < m_queues.size() ? tl_queueIndex : 0;
+  auto &queue = *m_queues[queueIndex];
+  {
+    std::lock_guard lock{queue.mutex};
+    queue.jobs.push_back(std::move(job));
+  }
+  m_numQueued.fetch_add(1);
+  // Otherwise a worker could miss the notification (between checking the
+  // counter and going to sleep).
+  { std::lock_guard lock{m_sleepMutex}; }
+  m_wakeUp.notify_one();
+}
+JobSystem::JobHandle JobSystem::_pop() {
+  if (m_numQueued.load() == 0) return nullptr;
+
+  const auto numQueues = static_cast<uint32_t>(m_queues.size());
+  const auto self = tl_queueIndex < numQueues ? tl_queueIndex : 0;
+  // Own queue first (the newest job, its data is likely still in the cache),
+  // then steal the oldest one from the others.
+  for (auto i = 0u; i < numQueues; ++i) {
+    auto &[mutex, jobs] = *m_queues[(self + i) % numQueues];
+    std::lock_guard lock{mutex};
+    if (jobs.empty()) continue;
+
+    JobHandle job;
+    if (i == 0) {
+      job = std::move(jobs.back());
+      jobs.pop_back();
+    } else {
+      job = std::move(jobs.front());
+      jobs.pop_front();
+    }
+    m_numQueued.fetch_sub(1);
+    return job;
+  }
+  return nullptr;
+}
+void JobSystem::_execute(const JobHandle &job) {
+  ZoneScoped;
+
+  job->function();
+  job->function = nullptr; // Releases the captures.
+
+  std::vector<JobHandle> dependents;
+  {
+    std::lock_guard lock{job->mutex};
+    job->finished = true;
+    dependents.swap(job->dependents);
+  }
+  job->done.store(true, std::memory_order_release);
+
+  for (auto &dependent : dependents) {
+    if (dependent->numPending.fetch_sub(1) == 1)
+      _enqueue(std::move(dependent));
+  }
+}
+
+void JobSystem::_workerLoop(uint32_t queueIndex) {
+  tl_queueIndex = queueIndex;
+  while (true) {
+    if (auto job = _pop()) {
+      _execute(job);
+      continue;
+    }
+    std::unique_lock lock{m_sleepMutex};
+    m_wakeUp.wait(lock, [this] { return m_stop || m_numQueued.load() > 0; });
+    if (m_stop) return;
+  }
+}
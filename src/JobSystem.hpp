@@ -0,0 +1,83 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
+
+/*
+ * @brief Runs jobs on a pool of worker threads. Each worker has its own queue
+ * (it takes the newest job from it), an idle worker steals the oldest job
+ * from the others. A thread that waits for a job runs other jobs meanwhile.
+ * @remark With 0 worker threads everything runs on the thread that waits,
+ * in a deterministic order.
+ * @remark Jobs must not throw.
+ */
+class JobSystem {
+public:
+  explicit JobSystem(uint32_t numThreads);
+  JobSystem(const JobSystem &) = delete;
+  JobSystem(JobSystem &&) noexcept = delete;
+  ~JobSystem();
+
+  JobSystem &operator=(const JobSystem &) = delete;
+  JobSystem &operator=(JobSystem &&) noexcept = delete;
+
+  struct Job;
+  using JobHandle = std::shared_ptr<Job>;
+  using RangeFunction =
+    std::function<void(std::size_t first, std::size_t last)>;
+
+  // @brief The job runs after all of its dependencies (null handles are
+  // ignored).
+  [[nodiscard]] JobHandle schedule(std::function<void()>,
+                                   std::initializer_list<JobHandle>
+                                     dependencies = {});
+  // @brief Splits [0, count) into ranges of at least grainSize elements (one
+  // range per thread at most).
+  // @return Finishes with the last range.
+  [[nodiscard]] JobHandle
+  scheduleParallelFor(std::size_t count, std::size_t grainSize, RangeFunction,
+                      std::initializer_list<JobHandle> dependencies = {});
+  // @brief Blocking version of the above.
+  void parallelFor(std::size_t count, std::size_t grainSize, RangeFunction);
+
+  // @brief Runs other jobs meanwhile (returns at once for a null handle).
+  void wait(const JobHandle &);
+
+  // @return Number of worker threads (the waiting thread not included).
+  [[nodiscard]] uint32_t getNumThreads() const;
+
+  // @return hardware_concurrency - 1 (the main thread takes part in waits).
+  [[nodiscard]] static uint32_t getDefaultNumThreads();
+
+private:
+  [[nodiscard]] JobHandle _schedule(std::function<void()>,
+                                    std::span<const JobHandle> dependencies);
+
+  void _enqueue(JobHandle);
+  [[nodiscard]] JobHandle _pop();
+  void _execute(const JobHandle &);
+
+  void _workerLoop(uint32_t queueIndex);
+
+private:
+  struct Queue {
+    std::mutex mutex;
+    std::deque<JobHandle> jobs;
+  };
+  // [0] = threads outside of the pool, then one per worker.
+  std::vector<std::unique_ptr<Queue>> m_queues;
+  std::atomic<uint32_t> m_numQueued{0};
+
+  std::mutex m_sleepMutex;
+  std::condition_variable m_wakeUp;
+  bool m_stop{false};
+
+  std::vector<std::thread> m_threads;
+};
@@ -8,6 +8,7 @@
 struct SubMesh {
   GeometryInfo geometryInfo;
   std::shared_ptr<Material> material;
+  AABB aabb; // In mesh space.
 };
 
 struct Mesh {
@@ -19,6 +20,6 @@ struct Mesh {
 
   AABB aabb{
     .min = glm::vec3{std::numeric_limits<float>::max()},
-    .max = glm::vec3{std::numeric_limits<float>::min()},
+    .max = glm::vec3{std::numeric_limits<float>::lowest()},
   };
 };
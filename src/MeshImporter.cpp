@@ -281,7 +281,7 @@ void MeshImporter::_fillVertexBuffer(const aiMesh &mesh, SubMeshInfo &info) {
     aiMatrix3x3{aiMatrix4x4{rootTransform}.Inverse().Transpose()};
 
   aiVector3D min{std::numeric_limits<float>::max()};
-  aiVector3D max{std::numeric_limits<float>::min()};
+  aiVector3D max{std::numeric_limits<float>::lowest()};
 
   for (uint32_t i{0}; i < mesh.mNumVertices; ++i) {
     const auto pos = rootTransform * mesh.mVertices[i];
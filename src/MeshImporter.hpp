@@ -108,7 +108,7 @@ private:
 
   AABB m_aabb{
     .min = glm::vec3{std::numeric_limits<float>::max()},
-    .max = glm::vec3{std::numeric_limits<float>::min()},
+    .max = glm::vec3{std::numeric_limits<float>::lowest()},
   };
 
   VertexInfo m_vertexInfo;
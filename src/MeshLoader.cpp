@@ -53,8 +53,11 @@ std::shared_ptr<Mesh> loadMesh(const std::filesystem::path &p,
 
   std::vector<SubMesh> subMeshes;
   for (auto &sm : meshImporter.getSubMeshes()) {
-    subMeshes.push_back(
-      {sm.geometryInfo, buildMaterial(sm.materialInfo, p, textureCache)});
+    subMeshes.push_back({
+      .geometryInfo = sm.geometryInfo,
+      .material = buildMaterial(sm.materialInfo, p, textureCache),
+      .aabb = sm.aabb,
+    });
   }
 
   return std::make_shared<Mesh>(Mesh{
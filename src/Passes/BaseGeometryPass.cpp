@@ -1,50 +1,217 @@
 #include "BaseGeometryPass.hpp"
 #include "../Hash.hpp"
 #include "spdlog/spdlog.h"
+#include "tracy/Tracy.hpp"
 
+#include <algorithm>
 #include <sstream>
 #include <format>
 
+namespace {
+
+// shaders/Resources/DrawData.glsl
+struct DrawData {
+  glm::mat4 modelMatrix;
+  glm::mat4 normalMatrix;
+  glm::mat4 modelViewProjMatrix;
+  int32_t materialFlags;
+  int32_t _padding[3];
+};
+static_assert(sizeof(DrawData) == 208);
+
+constexpr auto kDrawDataBinding = 2;
+
+[[nodiscard]] const GeometryInfo &getGeometryInfo(const Renderable &r) {
+  return r.mesh.subMeshes[r.subMeshIndex].geometryInfo;
+}
+
+[[nodiscard]] std::size_t hashPipeline(const VertexFormat &vertexFormat,
+                                       const Material *material) {
+  auto hash = vertexFormat.getHash();
+  if (material) hashCombine(hash, material->getHash());
+  return hash;
+}
+
+// Fewer renderables are not worth a thread.
+constexpr std::size_t kMinChunkSize{128};
+
+} // namespace
+
 //
 // BaseGeometryPass class:
 //
 
-BaseGeometryPass::BaseGeometryPass(RenderContext &rc) : m_renderContext{rc} {}
+BaseGeometryPass::BaseGeometryPass(RenderContext &rc, JobSystem &jobSystem)
+    : m_renderContext{rc}, m_jobSystem{jobSystem} {}
 BaseGeometryPass::~BaseGeometryPass() {
   for (auto &[_, pipeline] : m_pipelines)
     m_renderContext.destroy(pipeline);
 }
 
-void BaseGeometryPass::_setTransform(const PerspectiveCamera &camera,
-                                     const glm::mat4 &modelMatrix) {
-  _setTransform(camera.getViewProjection(), modelMatrix);
-}
-void BaseGeometryPass::_setTransform(const glm::mat4 &viewProjection,
-                                     const glm::mat4 &modelMatrix) {
-  m_renderContext.setUniformMat4("u_Transform.modelMatrix", modelMatrix)
-    .setUniformMat4("u_Transform.normalMatrix",
-                    glm::transpose(glm::inverse(glm::mat3(modelMatrix))))
-    .setUniformMat4("u_Transform.modelViewProjMatrix",
-                    viewProjection * modelMatrix);
+void BaseGeometryPass::_drawRenderables(
+  std::span<const Renderable *const> renderables,
+  const glm::mat4 &viewProjection, std::optional<uint32_t> firstTextureUnit,
+  const std::function<void()> &setupBatch) {
+  if (renderables.empty()) return;
+
+  auto &rc = m_renderContext;
+  std::erase_if(m_pendingPipelines, [this, &rc](std::size_t hash) {
+    return rc.isProgramReady(m_pipelines.at(hash));
+  });
+
+  const auto maxNumChunks = std::size_t{m_jobSystem.getNumThreads()} + 1;
+  const auto numChunks = std::min(
+    (renderables.size() + kMinChunkSize - 1) / kMinChunkSize, maxNumChunks);
+  const auto chunkSize = (renderables.size() + numChunks - 1) / numChunks;
+  if (m_chunks.size() < numChunks) m_chunks.resize(numChunks);
+
+  const auto record = [&](std::size_t chunkIdx) {
+    const auto first = std::min(chunkIdx * chunkSize, renderables.size());
+    _recordRenderables(
+      m_chunks[chunkIdx],
+      renderables.subspan(first,
+                          std::min(chunkSize, renderables.size() - first)),
+      viewProjection, firstTextureUnit, setupBatch);
+  };
+  {
+    ZoneScopedN("RecordDraws");
+    m_jobSystem.parallelFor(numChunks, 1,
+                            [&record](std::size_t first, std::size_t last) {
+                              for (auto i = first; i < last; ++i)
+                                record(i);
+                            });
+  }
+
+  for (std::size_t i{0}; i < numChunks; ++i)
+    m_chunks[i].commandList.replay(rc);
+
+  for (std::size_t i{0}; i < numChunks; ++i) {
+    for (const auto &[hash, vertexFormat, material] :
+         m_chunks[i].missingPipelines) {
+      if (!m_pipelines.contains(hash))
+        _createPipeline(hash, *vertexFormat, material);
+    }
+  }
 }
 
-GraphicsPipeline &
+GraphicsPipeline *
 BaseGeometryPass::_getPipeline(const VertexFormat &vertexFormat,
                                const Material *material) {
-  auto hash = vertexFormat.getHash();
-  if (material) hashCombine(hash, material->getHash());
+  const auto hash = hashPipeline(vertexFormat, material);
+  const auto it = m_pipelines.find(hash);
+  auto &basePassPipeline = it != m_pipelines.end()
+                             ? it->second
+                             : _createPipeline(hash, vertexFormat, material);
+
+  // The program is built asynchronously, can't draw with it yet.
+  return m_renderContext.isProgramReady(basePassPipeline) ? &basePassPipeline
+                                                          : nullptr;
+}
+
+void BaseGeometryPass::_recordRenderables(
+  Chunk &chunk, std::span<const Renderable *const> renderables,
+  const glm::mat4 &viewProjection, std::optional<uint32_t> firstTextureUnit,
+  const std::function<void()> &setupBatch) const {
+  ZoneScoped;
+
+  auto &[commandList, drawables, batches, missingPipelines] = chunk;
+  commandList.clear();
+  drawables.clear();
+  batches.clear();
+  missingPipelines.clear();
 
-  GraphicsPipeline *basePassPipeline{nullptr};
-  if (const auto it = m_pipelines.find(hash); it != m_pipelines.cend())
-    basePassPipeline = &it->second;
-  if (!basePassPipeline) {
-    auto pipeline = _createBasePassPipeline(vertexFormat, material);
-    SPDLOG_INFO("Created pipeline: {}", hash);
-    const auto &it =
-      m_pipelines.insert_or_assign(hash, std::move(pipeline)).first;
-    basePassPipeline = &it->second;
+  const auto canMerge = [bindTextures = firstTextureUnit.has_value()](
+                          const Renderable &a, const Renderable &b) {
+    const auto &lhs = getGeometryInfo(a);
+    const auto &rhs = getGeometryInfo(b);
+    return a.mesh.vertexBuffer == b.mesh.vertexBuffer &&
+           a.mesh.indexBuffer == b.mesh.indexBuffer &&
+           lhs.topology == rhs.topology &&
+           (lhs.numIndices > 0) == (rhs.numIndices > 0) &&
+           (!bindTextures || &a.material == &b.material);
+  };
+  for (const auto *renderable : renderables) {
+    const auto &vertexFormat = *renderable->mesh.vertexFormat;
+    const auto hash = hashPipeline(vertexFormat, &renderable->material);
+    const auto it = m_pipelines.find(hash);
+    if (it == m_pipelines.cend()) {
+      missingPipelines.push_back({hash, &vertexFormat, &renderable->material});
+      continue;
+    }
+    if (m_pendingPipelines.contains(hash)) continue;
+    const auto *pipeline = &it->second;
+
+    if (batches.empty() || batches.back().pipeline != pipeline ||
+        !canMerge(*drawables[batches.back().first], *renderable)) {
+      batches.push_back({.pipeline = pipeline, .first = drawables.size()});
+    }
+    ++batches.back().numDraws;
+    drawables.push_back(renderable);
+  }
+
+  for (const auto &[pipeline, first, numDraws] : batches) {
+    const auto batch = std::span{drawables}.subspan(first, numDraws);
+    const auto &[mesh, _0, material, _1, _2, _3] = *batch.front();
+    const auto &gi = getGeometryInfo(*batch.front());
+
+    commandList.setGraphicsPipeline(*pipeline);
+    const auto drawData =
+      commandList.bindStorageBuffer<DrawData>(kDrawDataBinding, numDraws);
+    for (std::size_t i{0}; i < batch.size(); ++i) {
+      const auto &modelMatrix = batch[i]->modelMatrix;
+      drawData[i] = {
+        .modelMatrix = modelMatrix,
+        .normalMatrix =
+          glm::mat4{glm::transpose(glm::inverse(glm::mat3{modelMatrix}))},
+        .modelViewProjMatrix = viewProjection * modelMatrix,
+        .materialFlags = batch[i]->flags,
+      };
+    }
+    if (firstTextureUnit) {
+      for (auto unit = *firstTextureUnit;
+           const auto &[_, texture] : material.getDefaultTextures()) {
+        commandList.bindTexture(unit++, *texture);
+      }
+    }
+    if (setupBatch) commandList.call(setupBatch);
+
+    if (gi.numIndices > 0) {
+      const auto commands = commandList.multiDrawIndirect(
+        *mesh.vertexBuffer, *mesh.indexBuffer, gi.topology, numDraws);
+      for (std::size_t i{0}; i < batch.size(); ++i) {
+        const auto &[_, vertexOffset, numVertices, indexOffset, numIndices] =
+          getGeometryInfo(*batch[i]);
+        commands[i] = {
+          .count = numIndices,
+          .firstIndex = indexOffset,
+          .baseVertex = static_cast<int32_t>(vertexOffset),
+        };
+      }
+    } else {
+      const auto commands = commandList.multiDrawIndirect(
+        *mesh.vertexBuffer, gi.topology, numDraws);
+      for (std::size_t i{0}; i < batch.size(); ++i) {
+        const auto &[_, vertexOffset, numVertices, indexOffset, numIndices] =
+          getGeometryInfo(*batch[i]);
+        commands[i] = {
+          .count = numVertices,
+          .first = vertexOffset,
+        };
+      }
+    }
   }
-  return *basePassPipeline;
+}
+
+GraphicsPipeline &
+BaseGeometryPass::_createPipeline(std::size_t hash,
+                                  const VertexFormat &vertexFormat,
+                                  const Material *material) {
+  auto &basePassPipeline =
+    m_pipelines.emplace(hash, _createBasePassPipeline(vertexFormat, material))
+      .first->second;
+  SPDLOG_INFO("Created pipeline: {}", hash);
+  m_pendingPipelines.insert(hash);
+  return basePassPipeline;
 }
 
 //
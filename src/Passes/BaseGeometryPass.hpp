@@ -2,25 +2,74 @@
 
 #include "../PerspectiveCamera.hpp"
 #include "../Renderable.hpp"
+#include "../CommandList.hpp"
+#include "../JobSystem.hpp"
+#include <functional>
+#include <unordered_set>
 
 class BaseGeometryPass {
 public:
-  explicit BaseGeometryPass(RenderContext &);
+  BaseGeometryPass(RenderContext &, JobSystem &);
   virtual ~BaseGeometryPass();
 
 protected:
-  void _setTransform(const PerspectiveCamera &, const glm::mat4 &modelMatrix);
-  void _setTransform(const glm::mat4 &viewProjection,
-                     const glm::mat4 &modelMatrix);
+  // Draws with glMultiDraw*Indirect, consecutive renderables that share
+  // a pipeline, geometry buffers and (if textures are bound) a material are
+  // merged into a single call. Per-draw data is fetched with gl_DrawID, hence
+  // the pipelines have to be built with MULTI_DRAW defined.
+  // Chunks of renderables are recorded into CommandLists on the JobSystem,
+  // then replayed (in order) on the calling (GL) thread. Renderables without a
+  // ready pipeline are skipped (missing pipelines are created after the
+  // replay).
+  // @param firstTextureUnit Where to bind material textures (nullopt = skip).
+  // @param setupBatch Called after the pipeline of a batch has been set.
+  void _drawRenderables(std::span<const Renderable *const>,
+                        const glm::mat4 &viewProjection,
+                        std::optional<uint32_t> firstTextureUnit,
+                        const std::function<void()> &setupBatch = {});
 
-  [[nodiscard]] GraphicsPipeline &_getPipeline(const VertexFormat &,
+  // @return nullptr if the pipeline is not ready yet (still compiling)
+  [[nodiscard]] GraphicsPipeline *_getPipeline(const VertexFormat &,
                                                const Material *);
   virtual GraphicsPipeline _createBasePassPipeline(const VertexFormat &,
                                                    const Material *) = 0;
 
+private:
+  struct Batch {
+    const GraphicsPipeline *pipeline;
+    std::size_t first; // Index of the first renderable (in drawables).
+    uint32_t numDraws;
+  };
+  struct PipelineRequest {
+    std::size_t hash;
+    const VertexFormat *vertexFormat;
+    const Material *material;
+  };
+  // Scratch of a recording thread, reused across calls.
+  struct Chunk {
+    CommandList commandList;
+    std::vector<const Renderable *> drawables;
+    std::vector<Batch> batches;
+    std::vector<PipelineRequest> missingPipelines;
+  };
+
+  // @brief Thread-safe, as long as the pipelines are not modified.
+  void _recordRenderables(Chunk &, std::span<const Renderable *const>,
+                          const glm::mat4 &viewProjection,
+                          std::optional<uint32_t> firstTextureUnit,
+                          const std::function<void()> &setupBatch) const;
+
+  GraphicsPipeline &_createPipeline(std::size_t hash, const VertexFormat &,
+                                    const Material *);
+
 protected:
   RenderContext &m_renderContext;
+  JobSystem &m_jobSystem;
   std::unordered_map<std::size_t, GraphicsPipeline> m_pipelines;
+
+private:
+  std::unordered_set<std::size_t> m_pendingPipelines; // Still compiling.
+  std::vector<Chunk> m_chunks;
 };
 
 [[nodiscard]] std::string getSamplersChunk(const TextureResources &,
@@ -40,9 +40,9 @@ FrameGraphResource Blit::addColor(FrameGraph &fg, FrameGraphResource target,
                                   FrameGraphResource source) {
   assert(target != source);
 
-  fg.addCallbackPass(
-    "AddColor",
-    [&](FrameGraph::Builder &builder, auto &) {
+  addCallbackPass(
+    fg, "AddColor",
+    [&](PassBuilder &builder, auto &) {
       builder.read(source);
 
       target = builder.write(target);
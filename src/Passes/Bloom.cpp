@@ -48,9 +48,9 @@ FrameGraphResource Bloom::compose(FrameGraph &fg, FrameGraphResource scene,
   struct Data {
     FrameGraphResource output;
   };
-  const auto data = fg.addCallbackPass<Data>(
-    "Bloom",
-    [&](FrameGraph::Builder &builder, Data &data) {
+  const auto data = addCallbackPass<Data>(
+    fg, "Bloom",
+    [&](PassBuilder &builder, Data &data) {
       builder.read(scene);
       builder.read(bloom);
 
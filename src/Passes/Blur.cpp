@@ -39,16 +39,15 @@ FrameGraphResource Blur::addTwoPassGaussianBlur(FrameGraph &fg,
 
 FrameGraphResource Blur::_addPass(FrameGraph &fg, FrameGraphResource input,
                                   float scale, bool horizontal) {
-  const auto name =
-    (horizontal ? "Horizontal" : "Vertical") + std::string{"Blur"};
+  const std::string_view name{horizontal ? "HorizontalBlur" : "VerticalBlur"};
   const auto &desc = fg.getDescriptor<FrameGraphTexture>(input);
 
   struct Data {
     FrameGraphResource output;
   };
-  auto &pass = fg.addCallbackPass<Data>(
-    name,
-    [&](FrameGraph::Builder &builder, Data &data) {
+  auto &pass = addCallbackPass<Data>(
+    fg, name,
+    [&](PassBuilder &builder, Data &data) {
       builder.read(input);
 
       data.output = builder.create<FrameGraphTexture>(
@@ -69,9 +69,9 @@ DeferredLightingPass::addPass(FrameGraph &fg, FrameGraphBlackboard &blackboard,
   struct Data {
     FrameGraphResource sceneColor;
   };
-  auto &deferredLighting = fg.addCallbackPass<Data>(
-    "DeferredLighting Pass",
-    [&](FrameGraph::Builder &builder, Data &data) {
+  auto &deferredLighting = addCallbackPass<Data>(
+    fg, "DeferredLighting Pass",
+    [&](PassBuilder &builder, Data &data) {
       builder.read(frameBlock);
 
       builder.read(gBuffer.depth);
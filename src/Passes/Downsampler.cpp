@@ -35,9 +35,9 @@ Downsampler::addPass(FrameGraph &fg, FrameGraphResource input, uint32_t level) {
   struct Data {
     FrameGraphResource downsampled;
   };
-  const auto [downsampled] = fg.addCallbackPass<Data>(
-    "Downsample",
-    [&](FrameGraph::Builder &builder, Data &data) {
+  const auto [downsampled] = addCallbackPass<Data>(
+    fg, "Downsample",
+    [&](PassBuilder &builder, Data &data) {
       builder.read(input);
 
       const auto &inputDesc = fg.getDescriptor<FrameGraphTexture>(input);
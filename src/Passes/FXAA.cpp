@@ -41,9 +41,9 @@ FrameGraphResource FXAA::addPass(FrameGraph &fg,
   struct Data {
     FrameGraphResource output;
   };
-  auto &pass = fg.addCallbackPass<Data>(
-    "FXAA",
-    [&](FrameGraph::Builder &builder, Data &data) {
+  auto &pass = addCallbackPass<Data>(
+    fg, "FXAA",
+    [&](PassBuilder &builder, Data &data) {
       builder.read(frameBlock);
       builder.read(input);
 
@@ -129,9 +129,9 @@ void FinalPass::compose(FrameGraph &fg, const FrameGraphBlackboard &blackboard,
   }
   if (output == -1) mode = Mode_Discard;
 
-  fg.addCallbackPass(
-    "FinalComposition",
-    [&](FrameGraph::Builder &builder, auto &) {
+  addCallbackPass(
+    fg, "FinalComposition",
+    [&](PassBuilder &builder, auto &) {
       builder.read(frameBlock);
       if (mode != Mode_Discard) builder.read(output);
       builder.setSideEffect();
@@ -18,18 +18,17 @@ constexpr auto kFirstFreeTextureBinding = 0;
 
 }
 
-GBufferPass::GBufferPass(RenderContext &rc) : BaseGeometryPass{rc} {}
+GBufferPass::GBufferPass(RenderContext &rc, JobSystem &jobSystem)
+    : BaseGeometryPass{rc, jobSystem} {}
 
-void GBufferPass::addGeometryPass(FrameGraph &fg,
-                                  FrameGraphBlackboard &blackboard,
-                                  Extent2D resolution,
-                                  const PerspectiveCamera &camera,
-                                  std::span<const Renderable *> renderables) {
+void GBufferPass::addGeometryPass(
+  FrameGraph &fg, FrameGraphBlackboard &blackboard, Extent2D resolution,
+  const PerspectiveCamera &camera, const RenderableList &renderables) {
   const auto [frameBlock] = blackboard.get<FrameData>();
 
-  blackboard.add<GBufferData>() = fg.addCallbackPass<GBufferData>(
-    "GBuffer Pass",
-    [&](FrameGraph::Builder &builder, GBufferData &data) {
+  blackboard.add<GBufferData>() = addCallbackPass<GBufferData>(
+    fg, "GBuffer Pass",
+    [&](PassBuilder &builder, GBufferData &data) {
       builder.read(frameBlock);
 
       data.depth = builder.create<FrameGraphTexture>(
@@ -54,8 +53,8 @@ void GBufferPass::addGeometryPass(FrameGraph &fg,
         {.extent = resolution, .format = PixelFormat::RGBA8_UNorm});
       data.metallicRoughnessAO = builder.write(data.metallicRoughnessAO);
     },
-    [=, this, camera = &camera](const GBufferData &data,
-                                FrameGraphPassResources &resources, void *ctx) {
+    [=, this, camera = &camera, renderables = &renderables](
+      const GBufferData &data, FrameGraphPassResources &resources, void *ctx) {
       NAMED_DEBUG_MARKER("GBuffer");
       TracyGpuZone("GBuffer");
 
@@ -90,22 +89,9 @@ void GBufferPass::addGeometryPass(FrameGraph &fg,
       };
       auto &rc = *static_cast<RenderContext *>(ctx);
       const auto framebuffer = rc.beginRendering(renderingInfo);
-      for (const auto &renderable : renderables) {
-        auto &[mesh, subMeshIndex, material, flags, modelMatrix, _] =
-          *renderable;
-
-        rc.setGraphicsPipeline(_getPipeline(*mesh.vertexFormat, &material))
-          .bindUniformBuffer(0, getBuffer(resources, frameBlock));
-
-        _setTransform(*camera, modelMatrix);
-        for (uint32_t unit{kFirstFreeTextureBinding};
-             const auto &[_, texture] : material.getDefaultTextures()) {
-          rc.bindTexture(unit++, *texture);
-        }
-        rc.setUniform1i("u_MaterialFlags", flags)
-          .draw(*mesh.vertexBuffer, *mesh.indexBuffer,
-                mesh.subMeshes[subMeshIndex].geometryInfo);
-      }
+      rc.bindUniformBuffer(0, getBuffer(resources, frameBlock));
+      _drawRenderables(*renderables, camera->getViewProjection(),
+                       kFirstFreeTextureBinding);
       rc.endRendering(framebuffer);
     });
 }
@@ -118,7 +104,8 @@ GBufferPass::_createBasePassPipeline(const VertexFormat &vertexFormat,
   const auto vao = m_renderContext.getVertexArray(vertexFormat.getAttributes());
 
   ShaderCodeBuilder shaderCodeBuilder;
-  shaderCodeBuilder.setDefines(buildDefines(vertexFormat));
+  shaderCodeBuilder.setDefines(buildDefines(vertexFormat))
+    .addDefine("MULTI_DRAW", 1);
 
   const auto vertCode =
     shaderCodeBuilder.replace("#pragma USER_CODE", material->getUserVertCode())
@@ -136,7 +123,7 @@ GBufferPass::_createBasePassPipeline(const VertexFormat &vertexFormat,
       .build("GBufferPass.frag");
 
   const auto program =
-    m_renderContext.createGraphicsProgram(vertCode, fragCode);
+    m_renderContext.createGraphicsProgramAsync(vertCode, fragCode);
 
   return GraphicsPipeline::Builder{}
     .setDepthStencil({
@@ -2,16 +2,17 @@
 
 #include "fg/Fwd.hpp"
 #include "BaseGeometryPass.hpp"
-#include <span>
+#include <vector>
 
 class GBufferPass final : public BaseGeometryPass {
 public:
-  explicit GBufferPass(RenderContext &);
+  GBufferPass(RenderContext &, JobSystem &);
   ~GBufferPass() = default;
 
+  // @param renderables Read when the pass executes (must outlive the graph).
   void addGeometryPass(FrameGraph &, FrameGraphBlackboard &,
                        Extent2D resolution, const PerspectiveCamera &,
-                       std::span<const Renderable *>);
+                       const RenderableList &renderables);
 
 private:
   GraphicsPipeline _createBasePassPipeline(const VertexFormat &,
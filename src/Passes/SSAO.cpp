@@ -30,9 +30,9 @@ void SSAO::addPass(FrameGraph &fg, FrameGraphBlackboard &blackboard) {
   const auto &gBuffer = blackboard.get<GBufferData>();
   const auto extent = fg.getDescriptor<FrameGraphTexture>(gBuffer.depth).extent;
 
-  blackboard.add<SSAOData>() = fg.addCallbackPass<SSAOData>(
-    "SSAO",
-    [&](FrameGraph::Builder &builder, SSAOData &data) {
+  blackboard.add<SSAOData>() = addCallbackPass<SSAOData>(
+    fg, "SSAO",
+    [&](PassBuilder &builder, SSAOData &data) {
       builder.read(frameBlock);
       builder.read(gBuffer.depth);
       builder.read(gBuffer.normal);
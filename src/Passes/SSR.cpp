@@ -43,9 +43,9 @@ FrameGraphResource SSR::addPass(FrameGraph &fg,
   const auto extent = fg.getDescriptor<FrameGraphTexture>(gBuffer.depth).extent;
   const auto &sceneColor = blackboard.get<SceneColorData>();
 
-  auto &pass = fg.addCallbackPass<ReflectionsData>(
-    "SSR",
-    [&](FrameGraph::Builder &builder, ReflectionsData &data) {
+  auto &pass = addCallbackPass<ReflectionsData>(
+    fg, "SSR",
+    [&](PassBuilder &builder, ReflectionsData &data) {
       builder.read(frameBlock);
 
       builder.read(gBuffer.depth);
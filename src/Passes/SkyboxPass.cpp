@@ -47,9 +47,9 @@ FrameGraphResource SkyboxPass::addPass(FrameGraph &fg,
 
   const auto skybox = importTexture(fg, "Skybox", cubemap);
 
-  fg.addCallbackPass(
-    "Skybox Pass",
-    [&](FrameGraph::Builder &builder, auto &) {
+  addCallbackPass(
+    fg, "Skybox Pass",
+    [&](PassBuilder &builder, auto &) {
       builder.read(frameBlock);
       builder.read(gBuffer.depth);
       builder.read(skybox);
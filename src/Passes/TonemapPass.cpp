@@ -37,9 +37,9 @@ FrameGraphResource TonemapPass::addPass(FrameGraph &fg,
   struct Data {
     FrameGraphResource output;
   };
-  auto &pass = fg.addCallbackPass<Data>(
-    "Tonemapping",
-    [&](FrameGraph::Builder &builder, Data &data) {
+  auto &pass = addCallbackPass<Data>(
+    fg, "Tonemapping",
+    [&](PassBuilder &builder, Data &data) {
       builder.read(input);
 
       data.output = builder.create<FrameGraphTexture>(
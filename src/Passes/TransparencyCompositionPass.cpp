@@ -48,9 +48,9 @@ FrameGraphResource TransparencyCompositionPass::addPass(
   const auto &weightedBlended = blackboard.get<WeightedBlendedData>();
   const auto extent = fg.getDescriptor<FrameGraphTexture>(target).extent;
 
-  fg.addCallbackPass(
-    "TransparencyComposition",
-    [&](FrameGraph::Builder &builder, auto &) {
+  addCallbackPass(
+    fg, "TransparencyComposition",
+    [&](PassBuilder &builder, auto &) {
       builder.read(weightedBlended.accum);
       builder.read(weightedBlended.reveal);
 
@@ -36,9 +36,9 @@ FrameGraphResource Upsampler::addPass(FrameGraph &fg, FrameGraphResource input,
   struct Data {
     FrameGraphResource upsampled;
   };
-  auto [upsampled] = fg.addCallbackPass<Data>(
-    "Upsample",
-    [&](FrameGraph::Builder &builder, Data &data) {
+  auto [upsampled] = addCallbackPass<Data>(
+    fg, "Upsample",
+    [&](PassBuilder &builder, Data &data) {
       builder.read(input);
 
       const auto &inputDesc = fg.getDescriptor<FrameGraphTexture>(input);
@@ -36,9 +36,9 @@ FrameGraphResource VignettePass::addPass(FrameGraph &fg,
   struct Data {
     FrameGraphResource output;
   };
-  auto &pass = fg.addCallbackPass<Data>(
-    "Vignette",
-    [&](FrameGraph::Builder &builder, Data &data) {
+  auto &pass = addCallbackPass<Data>(
+    fg, "Vignette",
+    [&](PassBuilder &builder, Data &data) {
       builder.read(input);
 
       data.output = builder.create<FrameGraphTexture>(
@@ -25,13 +25,14 @@ constexpr auto kFirstFreeTextureBinding = 5;
 
 }
 
-WeightedBlendedPass::WeightedBlendedPass(RenderContext &rc, uint32_t tileSize)
-    : BaseGeometryPass{rc}, m_tileSize{tileSize} {}
-
-void WeightedBlendedPass::addPass(FrameGraph &fg,
-                                  FrameGraphBlackboard &blackboard,
-                                  const PerspectiveCamera &camera,
-                                  std::span<const Renderable *> renderables) {
+WeightedBlendedPass::WeightedBlendedPass(RenderContext &rc,
+                                         JobSystem &jobSystem,
+                                         uint32_t tileSize)
+    : BaseGeometryPass{rc, jobSystem}, m_tileSize{tileSize} {}
+
+void WeightedBlendedPass::addPass(
+  FrameGraph &fg, FrameGraphBlackboard &blackboard,
+  const PerspectiveCamera &camera, const RenderableList &renderables) {
   const auto [frameBlock] = blackboard.get<FrameData>();
 
   const auto &gBuffer = blackboard.get<GBufferData>();
@@ -46,9 +47,9 @@ void WeightedBlendedPass::addPass(FrameGraph &fg,
   const auto &cascades = blackboard.get<ShadowMapData>();
 
   blackboard.add<WeightedBlendedData>() =
-    fg.addCallbackPass<WeightedBlendedData>(
-      "WeightedBlended OIT",
-      [&](FrameGraph::Builder &builder, WeightedBlendedData &data) {
+    addCallbackPass<WeightedBlendedData>(
+      fg, "WeightedBlended OIT",
+      [&](PassBuilder &builder, WeightedBlendedData &data) {
         builder.read(frameBlock);
 
         builder.read(gBuffer.depth);
@@ -72,9 +73,9 @@ void WeightedBlendedPass::addPass(FrameGraph &fg,
           "Reveal", {.extent = extent, .format = PixelFormat::R8_UNorm});
         data.reveal = builder.write(data.reveal);
       },
-      [=, this, camera = &camera](const WeightedBlendedData &data,
-                                  FrameGraphPassResources &resources,
-                                  void *ctx) {
+      [=, this, camera = &camera, renderables = &renderables](
+        const WeightedBlendedData &data, FrameGraphPassResources &resources,
+        void *ctx) {
         NAMED_DEBUG_MARKER("WeightedBlended OIT");
         TracyGpuZone("WeightedBlended OIT");
 
@@ -116,20 +117,8 @@ void WeightedBlendedPass::addPass(FrameGraph &fg,
           .bindUniformBuffer(1,
                              getBuffer(resources, cascades.viewProjMatrices));
 
-        for (const auto *renderable : renderables) {
-          const auto &[mesh, subMeshIndex, material, flags, modelMatrix, _] =
-            *renderable;
-
-          rc.setGraphicsPipeline(_getPipeline(*mesh.vertexFormat, &material));
-          _setTransform(*camera, modelMatrix);
-          for (uint32_t unit{kFirstFreeTextureBinding};
-               const auto &[_, texture] : material.getDefaultTextures()) {
-            rc.bindTexture(unit++, *texture);
-          }
-          rc.setUniform1i("u_MaterialFlags", flags)
-            .draw(*mesh.vertexBuffer, *mesh.indexBuffer,
-                  mesh.subMeshes[subMeshIndex].geometryInfo);
-        }
+        _drawRenderables(*renderables, camera->getViewProjection(),
+                         kFirstFreeTextureBinding);
         rc.endRendering(framebuffer);
       });
 }
@@ -142,7 +131,8 @@ WeightedBlendedPass::_createBasePassPipeline(const VertexFormat &vertexFormat,
   const auto vao = m_renderContext.getVertexArray(vertexFormat.getAttributes());
 
   ShaderCodeBuilder shaderCodeBuilder;
-  shaderCodeBuilder.setDefines(buildDefines(vertexFormat));
+  shaderCodeBuilder.setDefines(buildDefines(vertexFormat))
+    .addDefine("MULTI_DRAW", 1);
 
   const auto vertCode =
     shaderCodeBuilder.replace("#pragma USER_CODE", material->getUserVertCode())
@@ -162,7 +152,7 @@ WeightedBlendedPass::_createBasePassPipeline(const VertexFormat &vertexFormat,
       .build("WeightedBlendedPass.frag");
 
   const auto program =
-    m_renderContext.createGraphicsProgram(vertCode, fragCode);
+    m_renderContext.createGraphicsProgramAsync(vertCode, fragCode);
 
   return GraphicsPipeline::Builder{}
     .setDepthStencil({
@@ -2,18 +2,19 @@
 
 #include "fg/Fwd.hpp"
 #include "BaseGeometryPass.hpp"
-#include <span>
+#include <vector>
 
 class FrameGraph;
 class FrameGraphBlackboard;
 
 class WeightedBlendedPass final : public BaseGeometryPass {
 public:
-  WeightedBlendedPass(RenderContext &, uint32_t tileSize);
+  WeightedBlendedPass(RenderContext &, JobSystem &, uint32_t tileSize);
   ~WeightedBlendedPass() = default;
 
+  // @param renderables Read when the pass executes (must outlive the graph).
   void addPass(FrameGraph &, FrameGraphBlackboard &, const PerspectiveCamera &,
-               std::span<const Renderable *>);
+               const RenderableList &renderables);
 
 private:
   GraphicsPipeline _createBasePassPipeline(const VertexFormat &,
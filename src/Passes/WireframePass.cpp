@@ -11,22 +11,23 @@
 
 #include "tracy/TracyOpenGL.hpp"
 
-WireframePass::WireframePass(RenderContext &rc) : BaseGeometryPass{rc} {}
+WireframePass::WireframePass(RenderContext &rc, JobSystem &jobSystem)
+    : BaseGeometryPass{rc, jobSystem} {}
 
 FrameGraphResource WireframePass::addGeometryPass(
   FrameGraph &fg, FrameGraphBlackboard &blackboard, FrameGraphResource target,
-  const PerspectiveCamera &camera, std::span<const Renderable *> renderables) {
+  const PerspectiveCamera &camera, const RenderableList &renderables) {
   const auto &gBuffer = blackboard.get<GBufferData>();
 
-  fg.addCallbackPass(
-    "Wireframe Pass",
-    [&](FrameGraph::Builder &builder, auto &) {
+  addCallbackPass(
+    fg, "Wireframe Pass",
+    [&](PassBuilder &builder, auto &) {
       builder.read(gBuffer.depth);
 
       target = builder.write(target);
     },
-    [=, this, camera = &camera](const auto &,
-                                FrameGraphPassResources &resources, void *ctx) {
+    [=, this, camera = &camera, renderables = &renderables](
+      const auto &, FrameGraphPassResources &resources, void *ctx) {
       NAMED_DEBUG_MARKER("WireframePass");
       TracyGpuZone("WireframePass");
 
@@ -44,11 +45,14 @@ FrameGraphResource WireframePass::addGeometryPass(
       };
       auto &rc = *static_cast<RenderContext *>(ctx);
       const auto framebuffer = rc.beginRendering(renderingInfo);
-      for (const auto *renderable : renderables) {
+      for (const auto *renderable : *renderables) {
         const auto &[mesh, subMeshIndex, material, _0, modelMatrix, _1] =
           *renderable;
 
-        rc.setGraphicsPipeline(_getPipeline(*mesh.vertexFormat, nullptr))
+        const auto *pipeline = _getPipeline(*mesh.vertexFormat, nullptr);
+        if (!pipeline) continue;
+
+        rc.setGraphicsPipeline(*pipeline)
           .setUniformMat4("u_Transform.modelViewProjMatrix",
                           camera->getViewProjection() * modelMatrix)
           .draw(*mesh.vertexBuffer, *mesh.indexBuffer,
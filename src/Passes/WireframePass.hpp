@@ -2,20 +2,20 @@
 
 #include "fg/Fwd.hpp"
 #include "BaseGeometryPass.hpp"
-#include <span>
+#include <vector>
 
 class FrameGraph;
 class FrameGraphBlackboard;
 
 class WireframePass final : public BaseGeometryPass {
 public:
-  explicit WireframePass(RenderContext &);
+  WireframePass(RenderContext &, JobSystem &);
   ~WireframePass() = default;
 
   [[nodiscard]] FrameGraphResource
   addGeometryPass(FrameGraph &, FrameGraphBlackboard &,
                   FrameGraphResource target, const PerspectiveCamera &,
-                  std::span<const Renderable *>);
+                  const RenderableList &renderables);
 
 private:
   GraphicsPipeline _createBasePassPipeline(const VertexFormat &,
@@ -5,11 +5,11 @@
 class PerspectiveCamera {
 public:
   PerspectiveCamera() = default;
-  PerspectiveCamera(const PerspectiveCamera &) = delete;
+  PerspectiveCamera(const PerspectiveCamera &) = default;
   PerspectiveCamera(PerspectiveCamera &&) noexcept = default;
   ~PerspectiveCamera() = default;
 
-  PerspectiveCamera &operator=(const PerspectiveCamera &) = delete;
+  PerspectiveCamera &operator=(const PerspectiveCamera &) = default;
   PerspectiveCamera &operator=(PerspectiveCamera &&) noexcept = default;
 
   PerspectiveCamera &setPerspective(float fov, float aspectRatio, float zNear,
@@ -0,0 +1,75 @@
+#include "ProgramCache.hpp"
+#include "spdlog/spdlog.h"
+
+#include <fstream>
+#include <format>
+
+namespace {
+
+constexpr uint32_t kMagic{0x42505846}; // "FXPB"
+constexpr uint32_t kVersion{2};
+
+struct Header {
+  uint32_t magic{kMagic};
+  uint32_t version{kVersion};
+  uint64_t driverHash{0};
+  uint64_t sourceDigest{0};
+  GLenum format{GL_NONE};
+  uint64_t size{0};
+};
+
+} // namespace
+
+//
+// ProgramCache class:
+//
+
+ProgramCache::ProgramCache(std::filesystem::path directory)
+    : m_directory{std::move(directory)} {}
+
+std::optional<ProgramBinary>
+ProgramCache::load(const ProgramKey &key) const {
+  std::ifstream file{_makePath(key), std::ios::binary};
+  if (!file.is_open()) return std::nullopt;
+
+  Header header;
+  if (!file.read(reinterpret_cast<char *>(&header), sizeof(Header)) ||
+      header.magic != kMagic || header.version != kVersion ||
+      header.driverHash != key.driverHash ||
+      header.sourceDigest != key.sourceDigest || header.size == 0) {
+    return std::nullopt;
+  }
+  ProgramBinary binary{
+    .format = header.format,
+    .data = std::vector<char>(header.size),
+  };
+  if (!file.read(binary.data.data(), binary.data.size())) return std::nullopt;
+
+  return binary;
+}
+void ProgramCache::store(const ProgramKey &key,
+                         const ProgramBinary &binary) const {
+  std::error_code ec;
+  std::filesystem::create_directories(m_directory, ec);
+
+  const auto path = _makePath(key);
+  std::ofstream file{path, std::ios::binary | std::ios::trunc};
+  const Header header{
+    .driverHash = key.driverHash,
+    .sourceDigest = key.sourceDigest,
+    .format = binary.format,
+    .size = binary.data.size(),
+  };
+  if (!file.write(reinterpret_cast<const char *>(&header), sizeof(Header)) ||
+      !file.write(binary.data.data(), binary.data.size())) {
+    SPDLOG_WARN("Could not write: {}", path.string());
+  }
+}
+void ProgramCache::remove(const ProgramKey &key) const {
+  std::error_code ec;
+  std::filesystem::remove(_makePath(key), ec);
+}
+
+std::filesystem::path ProgramCache::_makePath(const ProgramKey &key) const {
+  return m_directory / std::format("{:016x}.bin", key.hash);
+}
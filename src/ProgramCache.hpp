@@ -0,0 +1,46 @@
+#pragma once
+
+#include "glad/gl.h"
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <vector>
+
+// Stored along with the binary, a program is loaded only if all of it
+// matches (a file name is just a 64-bit hash, collisions are misses).
+struct ProgramKey {
+  std::size_t hash{0};       // Of the driver and the sources, names the file.
+  std::size_t driverHash{0}; // vendor + renderer + version
+  uint64_t sourceDigest{0};  // FNV-1a (independent of the hash).
+
+  bool operator==(const ProgramKey &) const = default;
+};
+
+struct ProgramBinary {
+  GLenum format{GL_NONE};
+  std::vector<char> data;
+};
+
+// @brief Keeps program binaries (see glGetProgramBinary) on disk.
+class ProgramCache {
+public:
+  explicit ProgramCache(std::filesystem::path directory);
+  ProgramCache(const ProgramCache &) = delete;
+  ProgramCache(ProgramCache &&) noexcept = default;
+  ~ProgramCache() = default;
+
+  ProgramCache &operator=(const ProgramCache &) = delete;
+  ProgramCache &operator=(ProgramCache &&) noexcept = default;
+
+  // @return std::nullopt if there is no binary for the key (or the file is
+  // of another program/driver).
+  [[nodiscard]] std::optional<ProgramBinary> load(const ProgramKey &) const;
+  void store(const ProgramKey &, const ProgramBinary &) const;
+  void remove(const ProgramKey &) const;
+
+private:
+  [[nodiscard]] std::filesystem::path _makePath(const ProgramKey &) const;
+
+private:
+  std::filesystem::path m_directory;
+};
@@ -6,11 +6,75 @@
 #include "spdlog/spdlog.h"
 
 #include <numeric>
+#include <array>
+#include <algorithm>
+#include <bit>
+#include <chrono>
 
+#include "tracy/Tracy.hpp"
 #include "tracy/TracyOpenGL.hpp"
 
 namespace {
 
+// The (one and only) RenderContext, used by DebugMarker.
+RenderContext *g_renderContext{nullptr};
+
+#ifdef RENDER_STATS
+#  define COUNT_RENDER_STAT(stat, n) _getRenderStats().stat += (n)
+
+[[nodiscard]] uint64_t countTriangles(PrimitiveTopology topology,
+                                      uint32_t numVertices) {
+  switch (topology) {
+  case PrimitiveTopology::TriangleList:
+    return numVertices / 3;
+  case PrimitiveTopology::TriangleStrip:
+    return numVertices > 2 ? numVertices - 2 : 0;
+  default:
+    return 0;
+  }
+}
+// @param commands Mapped memory of an indirect buffer (nullptr = unknown).
+template <typename Command>
+[[nodiscard]] uint64_t countTriangles(PrimitiveTopology topology,
+                                      const void *commands,
+                                      uint32_t drawCount) {
+  if (!commands) return 0;
+
+  uint64_t numTriangles{0};
+  for (const auto &cmd :
+       std::span{static_cast<const Command *>(commands), drawCount})
+    numTriangles += countTriangles(topology, cmd.count) * cmd.instanceCount;
+  return numTriangles;
+}
+#else
+#  define COUNT_RENDER_STAT(stat, n)
+#endif
+
+constexpr GLsizeiptr kUploadRingFrameSize{4 * 1024 * 1024}; // 4 MiB per frame
+
+constexpr uint64_t kFNVOffsetBasis{0xcbf29ce484222325};
+void fnv1a(uint64_t &hash, std::span<const std::byte> bytes) {
+  constexpr uint64_t kFNVPrime{0x100000001b3};
+  for (const auto b : bytes)
+    hash = (hash ^ static_cast<uint64_t>(b)) * kFNVPrime;
+}
+
+// Accumulates the lifetime of the object (in milliseconds).
+class ScopedTimer {
+  using clock = std::chrono::steady_clock;
+
+public:
+  explicit ScopedTimer(float &accumulator) : m_accumulator{accumulator} {}
+  ~ScopedTimer() {
+    using milliseconds = std::chrono::duration<float, std::milli>;
+    m_accumulator += milliseconds{clock::now() - m_begin}.count();
+  }
+
+private:
+  float &m_accumulator;
+  const clock::time_point m_begin{clock::now()};
+};
+
 // @return {data type, number of components, normalize}
 std::tuple<GLenum, GLint, GLboolean> statAttribute(VertexAttribute::Type type) {
   switch (type) {
@@ -100,11 +164,12 @@ std::tuple<GLenum, GLint, GLboolean> statAttribute(VertexAttribute::Type type) {
 // RenderContext class:
 //
 
-RenderContext::RenderContext() {
+RenderContext::RenderContext(const std::filesystem::path &programCacheDir) {
   if (!gladLoadGL(reinterpret_cast<GLADloadfunc>(glfwGetProcAddress))) {
     throw std::runtime_error{"Failed to initialize GLAD"};
   }
   _setupDebugCallback();
+  g_renderContext = this;
 
 #if GLM_CONFIG_CLIP_CONTROL & GLM_CLIP_CONTROL_ZO_BIT
   glClipControl(GL_LOWER_LEFT, GL_ZERO_TO_ONE);
@@ -114,11 +179,50 @@ RenderContext::RenderContext() {
   glEnable(GL_PROGRAM_POINT_SIZE);
 
   glCreateVertexArrays(1, &m_dummyVAO);
+
+  const auto getInteger = [](GLenum pname) {
+    GLint value{0};
+    glGetIntegerv(pname, &value);
+    return static_cast<std::size_t>(value);
+  };
+  const auto numTextureUnits = getInteger(GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS);
+  m_boundTextures.resize(numTextureUnits, GL_NONE);
+  m_pendingTextures.resize(numTextureUnits, GL_NONE);
+  m_boundSamplers.resize(numTextureUnits, GL_NONE);
+  m_pendingSamplers.resize(numTextureUnits, GL_NONE);
+  m_imageUnits.resize(getInteger(GL_MAX_IMAGE_UNITS));
+  m_uniformBuffers.resize(getInteger(GL_MAX_UNIFORM_BUFFER_BINDINGS));
+  m_storageBuffers.resize(getInteger(GL_MAX_SHADER_STORAGE_BUFFER_BINDINGS));
+
+  _createUploadRing(kUploadRingFrameSize);
+
+#ifdef GL_KHR_parallel_shader_compile
+  m_parallelShaderCompile = GLAD_GL_KHR_parallel_shader_compile;
+  // Let the implementation decide how many threads to use.
+  if (m_parallelShaderCompile) glMaxShaderCompilerThreadsKHR(0xFFFFFFFF);
+#endif
+
+  if (!programCacheDir.empty() &&
+      getInteger(GL_NUM_PROGRAM_BINARY_FORMATS) > 0) {
+    m_programCache.emplace(programCacheDir);
+    for (const auto name : {GL_VENDOR, GL_RENDERER, GL_VERSION}) {
+      const auto *str = reinterpret_cast<const char *>(glGetString(name));
+      hashCombine(m_driverHash, std::string_view{str});
+    }
+  }
 }
 RenderContext::~RenderContext() {
+  g_renderContext = nullptr;
+  for (auto [_, fence] : m_frameFences)
+    glDeleteSync(fence);
+  _destroyUploadRing();
   glDeleteVertexArrays(1, &m_dummyVAO);
   for (auto [_, vao] : m_vertexArrays)
     glDeleteVertexArrays(1, &vao);
+  for (auto [_, framebuffer] : m_framebuffers)
+    glDeleteFramebuffers(1, &framebuffer);
+  for (auto [_, view] : m_textureViews)
+    glDeleteTextures(1, &view);
 
   m_currentPipeline = {};
 }
@@ -142,6 +246,58 @@ IndexBuffer RenderContext::createIndexBuffer(IndexType indexType,
   return IndexBuffer{createBuffer(stride * capacity, data), indexType};
 }
 
+Buffer RenderContext::createStreamBuffer(GLsizeiptr size) {
+  assert(size > 0);
+  auto &ring = m_uploadRing;
+
+  const auto alignUp = [alignment = ring.alignment](GLsizeiptr v) {
+    return (v + alignment - 1) / alignment * alignment;
+  };
+  ring.highWaterMark = alignUp(ring.highWaterMark) + size;
+
+  const auto alignedHead = alignUp(ring.head);
+  if (alignedHead + size > ring.frameSize) {
+    constexpr GLbitfield kFlags{GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT |
+                                GL_MAP_COHERENT_BIT};
+    GLuint id;
+    glCreateBuffers(1, &id);
+    glNamedBufferStorage(id, size, nullptr, kFlags);
+    auto &buffer = ring.overflowBuffers.emplace_back(Buffer{id, size});
+    buffer.m_mappedMemory = glMapNamedBufferRange(id, 0, size, kFlags);
+
+    Buffer view{id, size};
+    view.m_mappedMemory = buffer.m_mappedMemory;
+    view.m_isView = true;
+    return view;
+  }
+  ring.head = alignedHead + size;
+
+  Buffer view{ring.buffer.m_id, size};
+  view.m_offset = (ring.frameIndex * ring.frameSize) + alignedHead;
+  view.m_mappedMemory =
+    static_cast<std::byte *>(ring.buffer.m_mappedMemory) + view.m_offset;
+  view.m_isView = true;
+  return view;
+}
+Buffer RenderContext::createBufferView(const Buffer &buffer, GLintptr offset,
+                                       GLsizeiptr size) {
+  assert(buffer && !buffer.m_isView);
+  assert(size > 0 && offset + size <= buffer.m_size);
+  assert(offset % m_uploadRing.alignment == 0);
+
+  Buffer view{buffer.m_id, size};
+  view.m_offset = offset;
+  if (buffer.isMapped()) {
+    view.m_mappedMemory =
+      static_cast<std::byte *>(buffer.m_mappedMemory) + offset;
+  }
+  view.m_isView = true;
+  return view;
+}
+GLsizeiptr RenderContext::getBufferOffsetAlignment() const {
+  return m_uploadRing.alignment;
+}
+
 GLuint RenderContext::getVertexArray(const VertexAttributes &attributes) {
   assert(!attributes.empty());
 
@@ -160,16 +316,72 @@ GLuint RenderContext::getVertexArray(const VertexAttributes &attributes) {
 GLuint RenderContext::createGraphicsProgram(
   const std::string_view vertCode, const std::string_view fragCode,
   std::optional<const std::string_view> geomCode) {
-  return _createShaderProgram({
+  const ScopedTimer timer{m_programCacheStats.buildTime};
+
+  const auto key = _makeProgramKey({vertCode, geomCode.value_or(""), fragCode});
+  if (const auto program = _loadProgram(key); program != GL_NONE)
+    return program;
+
+  const auto program = _createShaderProgram({
     _createShader(GL_VERTEX_SHADER, vertCode),
     geomCode ? _createShader(GL_GEOMETRY_SHADER, *geomCode) : GL_NONE,
     _createShader(GL_FRAGMENT_SHADER, fragCode),
   });
+  _storeProgram(key, program);
+  return program;
 }
 GLuint RenderContext::createComputeProgram(const std::string_view code) {
-  return _createShaderProgram({
+  const ScopedTimer timer{m_programCacheStats.buildTime};
+
+  const auto key = _makeProgramKey({code});
+  if (const auto program = _loadProgram(key); program != GL_NONE)
+    return program;
+
+  const auto program = _createShaderProgram({
     _createShader(GL_COMPUTE_SHADER, code),
   });
+  _storeProgram(key, program);
+  return program;
+}
+
+GLuint RenderContext::createGraphicsProgramAsync(
+  const std::string_view vertCode, const std::string_view fragCode,
+  std::optional<const std::string_view> geomCode) {
+  const ScopedTimer timer{m_programCacheStats.buildTime};
+
+  const auto key = _makeProgramKey({vertCode, geomCode.value_or(""), fragCode});
+  if (const auto program = _loadProgram(key); program != GL_NONE)
+    return program;
+
+  std::vector<std::pair<GLenum, std::string>> sources;
+  sources.emplace_back(GL_VERTEX_SHADER, vertCode);
+  if (geomCode) sources.emplace_back(GL_GEOMETRY_SHADER, *geomCode);
+  sources.emplace_back(GL_FRAGMENT_SHADER, fragCode);
+
+  const auto program = glCreateProgram();
+  PendingProgram pending{.key = key};
+  if (m_parallelShaderCompile) {
+    // Status is checked later (see _pollProgram).
+    for (const auto &[type, code] : sources) {
+      const auto shader = glCreateShader(type);
+      const GLchar *strings{code.data()};
+      glShaderSource(shader, 1, &strings, nullptr);
+      glCompileShader(shader);
+      pending.shaders.push_back(shader);
+    }
+    _linkProgram(program, pending.shaders);
+  } else {
+    pending.sources = std::move(sources);
+    m_programQueue.push_back(program);
+  }
+  m_pendingPrograms.emplace(program, std::move(pending));
+  return program;
+}
+bool RenderContext::isProgramReady(GLuint program) {
+  return !m_pendingPrograms.contains(program) || _pollProgram(program);
+}
+bool RenderContext::isProgramReady(const GraphicsPipeline &gp) {
+  return isProgramReady(gp.m_program);
 }
 
 Texture RenderContext::createTexture2D(Extent2D extent, PixelFormat pixelFormat,
@@ -330,25 +542,41 @@ RenderContext &RenderContext::upload(Texture &texture, GLint mipLevel,
 RenderContext &RenderContext::clear(Buffer &buffer) {
   assert(buffer);
   uint8_t v{0};
-  glClearNamedBufferData(buffer.m_id, GL_R8, GL_RED, GL_UNSIGNED_BYTE, &v);
+  if (buffer.m_isView) {
+    glClearNamedBufferSubData(buffer.m_id, GL_R8, buffer.m_offset,
+                              buffer.m_size, GL_RED, GL_UNSIGNED_BYTE, &v);
+  } else {
+    glClearNamedBufferData(buffer.m_id, GL_R8, GL_RED, GL_UNSIGNED_BYTE, &v);
+  }
   return *this;
 }
 RenderContext &RenderContext::upload(Buffer &buffer, GLintptr offset,
                                      GLsizeiptr size, const void *data) {
   assert(buffer);
-  if (size > 0 && data != nullptr)
-    glNamedBufferSubData(buffer.m_id, offset, size, data);
+  if (size > 0 && data != nullptr) {
+    if (buffer.m_isView && buffer.isMapped()) {
+      // Persistently mapped (and coherent), no need to go through the driver.
+      assert(offset + size <= buffer.m_size);
+      memcpy(static_cast<std::byte *>(buffer.m_mappedMemory) + offset, data,
+             size);
+    } else {
+      assert(offset + size <= buffer.m_size);
+      glNamedBufferSubData(buffer.m_id, buffer.m_offset + offset, size, data);
+    }
+  }
   return *this;
 }
 void *RenderContext::map(Buffer &buffer) {
   assert(buffer);
+  // A view can not map a range of its (shared) buffer.
+  assert(!buffer.m_isView || buffer.isMapped());
   if (!buffer.isMapped())
     buffer.m_mappedMemory = glMapNamedBuffer(buffer, GL_WRITE_ONLY);
   return buffer.m_mappedMemory;
 }
 RenderContext &RenderContext::unmap(Buffer &buffer) {
   assert(buffer);
-  if (buffer.isMapped()) {
+  if (buffer.isMapped() && !buffer.m_isView) {
     glUnmapNamedBuffer(buffer);
     buffer.m_mappedMemory = nullptr;
   }
@@ -357,21 +585,28 @@ RenderContext &RenderContext::unmap(Buffer &buffer) {
 
 RenderContext &RenderContext::destroy(Buffer &buffer) {
   if (buffer) {
-    glDeleteBuffers(1, &buffer.m_id);
+    if (!buffer.m_isView) {
+      _forgetBindings(buffer);
+      glDeleteBuffers(1, &buffer.m_id);
+    }
     buffer = {};
   }
   return *this;
 }
 RenderContext &RenderContext::destroy(Texture &texture) {
   if (texture) {
+    _evictFramebuffers(texture.m_id);
+    _forgetBindings(texture);
+    _releaseTextureViews(texture.m_id);
     glDeleteTextures(1, &texture.m_id);
-    if (texture.m_view != GL_NONE) glDeleteTextures(1, &texture.m_view);
     texture = {};
   }
   return *this;
 }
 RenderContext &RenderContext::destroy(GraphicsPipeline &gp) {
   if (gp.m_program != GL_NONE) {
+    _discardPendingProgram(gp.m_program);
+    m_uniformLocations.erase(gp.m_program);
     glDeleteProgram(gp.m_program);
     gp.m_program = GL_NONE;
   }
@@ -382,6 +617,7 @@ RenderContext &RenderContext::destroy(GraphicsPipeline &gp) {
 RenderContext &RenderContext::dispatch(GLuint computeProgram,
                                        const glm::uvec3 &numGroups) {
   _setShaderProgram(computeProgram);
+  _flushTextureBindings();
   glDispatchCompute(numGroups.x, numGroups.y, numGroups.z);
   return *this;
 }
@@ -391,28 +627,7 @@ GLuint RenderContext::beginRendering(const RenderingInfo &renderingInfo) {
 
   TracyGpuZone("BeginRendering");
 
-  GLuint framebuffer;
-  glCreateFramebuffers(1, &framebuffer);
-  if (renderingInfo.depthAttachment.has_value()) {
-    _attachTexture(framebuffer, GL_DEPTH_ATTACHMENT,
-                   *renderingInfo.depthAttachment);
-  }
-  for (uint8_t i{0}; i < renderingInfo.colorAttachments.size(); ++i) {
-    _attachTexture(framebuffer, GL_COLOR_ATTACHMENT0 + i,
-                   renderingInfo.colorAttachments[i]);
-  }
-  if (const auto n = renderingInfo.colorAttachments.size(); n > 0) {
-    std::vector<GLenum> colorBuffers(n);
-    std::iota(colorBuffers.begin(), colorBuffers.end(), GL_COLOR_ATTACHMENT0);
-    glNamedFramebufferDrawBuffers(framebuffer, colorBuffers.size(),
-                                  colorBuffers.data());
-  }
-#ifdef _DEBUG
-  const auto status =
-    glCheckNamedFramebufferStatus(framebuffer, GL_DRAW_FRAMEBUFFER);
-  assert(GL_FRAMEBUFFER_COMPLETE == status);
-#endif
-
+  const auto framebuffer = _getFramebuffer(renderingInfo);
   glBindFramebuffer(GL_DRAW_FRAMEBUFFER, framebuffer);
   setViewport(renderingInfo.area);
   _setScissorTest(false);
@@ -459,7 +674,7 @@ RenderContext &RenderContext::beginRendering(
 RenderContext &RenderContext::endRendering(GLuint framebuffer) {
   assert(m_renderingStarted && framebuffer != GL_NONE);
 
-  glDeleteFramebuffers(1, &framebuffer);
+  // The framebuffer is owned by the cache (see _getFramebuffer).
   m_renderingStarted = false;
   return *this;
 }
@@ -493,68 +708,46 @@ RenderContext &RenderContext::setGraphicsPipeline(const GraphicsPipeline &gp) {
 
 RenderContext &RenderContext::setUniform1f(const std::string_view name,
                                            float f) {
-  const auto location =
-    glGetUniformLocation(m_currentPipeline.m_program, name.data());
-  if (location != GL_INVALID_INDEX)
-    glProgramUniform1f(m_currentPipeline.m_program, location, f);
+  const auto program = m_currentPipeline.m_program;
+  _setUniform(program, _getUniformLocation(program, name), f);
   return *this;
 }
 RenderContext &RenderContext::setUniform1i(const std::string_view name,
                                            int32_t i) {
-  const auto location =
-    glGetUniformLocation(m_currentPipeline.m_program, name.data());
-  if (location != GL_INVALID_INDEX)
-    glProgramUniform1i(m_currentPipeline.m_program, location, i);
+  const auto program = m_currentPipeline.m_program;
+  _setUniform(program, _getUniformLocation(program, name), i);
   return *this;
 }
 RenderContext &RenderContext::setUniform1ui(const std::string_view name,
                                             uint32_t i) {
-  const auto location =
-    glGetUniformLocation(m_currentPipeline.m_program, name.data());
-  if (location != GL_INVALID_INDEX)
-    glProgramUniform1ui(m_currentPipeline.m_program, location, i);
+  const auto program = m_currentPipeline.m_program;
+  _setUniform(program, _getUniformLocation(program, name), i);
   return *this;
 }
 
 RenderContext &RenderContext::setUniformVec3(const std::string_view name,
                                              const glm::vec3 &v) {
-  const auto location =
-    glGetUniformLocation(m_currentPipeline.m_program, name.data());
-  if (location != GL_INVALID_INDEX) {
-    glProgramUniform3fv(m_currentPipeline.m_program, location, 1,
-                        glm::value_ptr(v));
-  }
+  const auto program = m_currentPipeline.m_program;
+  _setUniform(program, _getUniformLocation(program, name), v);
   return *this;
 }
 RenderContext &RenderContext::setUniformVec4(const std::string_view name,
                                              const glm::vec4 &v) {
-  const auto location =
-    glGetUniformLocation(m_currentPipeline.m_program, name.data());
-  if (location != GL_INVALID_INDEX) {
-    glProgramUniform4fv(m_currentPipeline.m_program, location, 1,
-                        glm::value_ptr(v));
-  }
+  const auto program = m_currentPipeline.m_program;
+  _setUniform(program, _getUniformLocation(program, name), v);
   return *this;
 }
 
 RenderContext &RenderContext::setUniformMat3(const std::string_view name,
                                              const glm::mat3 &m) {
-  const auto location =
-    glGetUniformLocation(m_currentPipeline.m_program, name.data());
-  if (location != GL_INVALID_INDEX) {
-    glProgramUniformMatrix3fv(m_currentPipeline.m_program, location, 1,
-                              GL_FALSE, glm::value_ptr(m));
-  }
+  const auto program = m_currentPipeline.m_program;
+  _setUniform(program, _getUniformLocation(program, name), m);
   return *this;
 }
 RenderContext &RenderContext::setUniformMat4(const std::string_view name,
                                              const glm::mat4 &m) {
-  const auto location =
-    glGetUniformLocation(m_currentPipeline.m_program, name.data());
-  if (location != GL_INVALID_INDEX) {
-    glProgramUniformMatrix4fv(m_currentPipeline.m_program, location, 1,
-                              GL_FALSE, glm::value_ptr(m));
-  }
+  const auto program = m_currentPipeline.m_program;
+  _setUniform(program, _getUniformLocation(program, name), m);
   return *this;
 }
 
@@ -580,27 +773,71 @@ RenderContext &RenderContext::setScissor(const Rect2D &rect) {
 RenderContext &RenderContext::bindImage(GLuint unit, const Texture &texture,
                                         GLint mipLevel, GLenum access) {
   assert(texture && mipLevel < texture.m_numMipLevels);
-  glBindImageTexture(unit, texture, mipLevel, GL_FALSE, 0, access,
-                     static_cast<GLenum>(texture.m_pixelFormat));
+  assert(unit < m_imageUnits.size());
+
+  const ImageBinding binding{
+    .texture = texture,
+    .mipLevel = mipLevel,
+    .access = access,
+    .format = static_cast<GLenum>(texture.m_pixelFormat),
+  };
+  if (auto &current = m_imageUnits[unit]; current != binding) {
+    glBindImageTexture(unit, binding.texture, mipLevel, GL_FALSE, 0, access,
+                       binding.format);
+    current = binding;
+    ++m_bindingStats.numIssued;
+    ++m_bindingStats.numCalls;
+  } else {
+    ++m_bindingStats.numElided;
+  }
   return *this;
 }
 RenderContext &RenderContext::bindTexture(GLuint unit, const Texture &texture,
                                           std::optional<GLuint> samplerId) {
-  assert(texture);
-  glBindTextureUnit(unit, texture);
-  if (samplerId.has_value()) glBindSampler(unit, *samplerId);
+  assert(texture && unit < m_pendingTextures.size());
+
+  m_pendingTextures[unit] = texture;
+  if (samplerId.has_value()) m_pendingSamplers[unit] = *samplerId;
+
+  if (m_pendingTextures[unit] == m_boundTextures[unit] &&
+      m_pendingSamplers[unit] == m_boundSamplers[unit]) {
+    ++m_bindingStats.numElided;
+  } else {
+    ++m_bindingStats.numIssued;
+    m_firstDirtyUnit = std::min(m_firstDirtyUnit, unit);
+    m_lastDirtyUnit = std::max(m_lastDirtyUnit, unit);
+    COUNT_RENDER_STAT(numTextureBinds, 1);
+  }
   return *this;
 }
 RenderContext &RenderContext::bindUniformBuffer(GLuint index,
                                                 const UniformBuffer &buffer) {
-  assert(buffer);
-  glBindBufferBase(GL_UNIFORM_BUFFER, index, buffer);
+  assert(buffer && index < m_uniformBuffers.size());
+  if (const BufferBinding binding{buffer, buffer.m_offset, buffer.m_size};
+      m_uniformBuffers[index] != binding) {
+    glBindBufferRange(GL_UNIFORM_BUFFER, index, binding.buffer, binding.offset,
+                      binding.size);
+    m_uniformBuffers[index] = binding;
+    ++m_bindingStats.numIssued;
+    ++m_bindingStats.numCalls;
+  } else {
+    ++m_bindingStats.numElided;
+  }
   return *this;
 }
 RenderContext &RenderContext::bindStorageBuffer(GLuint index,
                                                 const StorageBuffer &buffer) {
-  assert(buffer);
-  glBindBufferBase(GL_SHADER_STORAGE_BUFFER, index, buffer);
+  assert(buffer && index < m_storageBuffers.size());
+  if (const BufferBinding binding{buffer, buffer.m_offset, buffer.m_size};
+      m_storageBuffers[index] != binding) {
+    glBindBufferRange(GL_SHADER_STORAGE_BUFFER, index, binding.buffer,
+                      binding.offset, binding.size);
+    m_storageBuffers[index] = binding;
+    ++m_bindingStats.numIssued;
+    ++m_bindingStats.numCalls;
+  } else {
+    ++m_bindingStats.numElided;
+  }
   return *this;
 }
 
@@ -623,6 +860,7 @@ RenderContext &
 RenderContext::draw(OptionalReference<const VertexBuffer> vertexBuffer,
                     OptionalReference<const IndexBuffer> indexBuffer,
                     const GeometryInfo &gi, uint32_t numInstances) {
+  _flushTextureBindings();
   if (vertexBuffer.has_value()) _setVertexBuffer(*vertexBuffer);
 
   if (gi.numIndices > 0) {
@@ -640,6 +878,54 @@ RenderContext::draw(OptionalReference<const VertexBuffer> vertexBuffer,
     glDrawArraysInstanced(static_cast<GLenum>(gi.topology), gi.vertexOffset,
                           gi.numVertices, numInstances);
   }
+  COUNT_RENDER_STAT(numDrawCalls, 1);
+  COUNT_RENDER_STAT(numTriangles,
+                    countTriangles(gi.topology, gi.numIndices > 0
+                                                  ? gi.numIndices
+                                                  : gi.numVertices) *
+                      numInstances);
+  return *this;
+}
+
+RenderContext &
+RenderContext::multiDrawIndirect(const VertexBuffer &vertexBuffer,
+                                 PrimitiveTopology topology,
+                                 const Buffer &commands, uint32_t drawCount) {
+  assert(drawCount > 0);
+  assert(static_cast<std::size_t>(commands.m_size) >=
+         sizeof(DrawArraysIndirectCommand) * drawCount);
+
+  _flushTextureBindings();
+  _setVertexBuffer(vertexBuffer);
+  glMultiDrawArraysIndirect(static_cast<GLenum>(topology),
+                            _setDrawIndirectBuffer(commands), drawCount, 0);
+  COUNT_RENDER_STAT(numDrawCalls, 1);
+  COUNT_RENDER_STAT(numTriangles, countTriangles<DrawArraysIndirectCommand>(
+                                    topology, commands.m_mappedMemory,
+                                    drawCount));
+  return *this;
+}
+RenderContext &
+RenderContext::multiDrawIndirect(const VertexBuffer &vertexBuffer,
+                                 const IndexBuffer &indexBuffer,
+                                 PrimitiveTopology topology,
+                                 const Buffer &commands, uint32_t drawCount) {
+  assert(drawCount > 0);
+  assert(static_cast<std::size_t>(commands.m_size) >=
+         sizeof(DrawElementsIndirectCommand) * drawCount);
+
+  _flushTextureBindings();
+  _setVertexBuffer(vertexBuffer);
+  _setIndexBuffer(indexBuffer);
+
+  const auto stride = static_cast<GLsizei>(indexBuffer.getIndexType());
+  glMultiDrawElementsIndirect(
+    static_cast<GLenum>(topology), getIndexDataType(stride),
+    _setDrawIndirectBuffer(commands), drawCount, 0);
+  COUNT_RENDER_STAT(numDrawCalls, 1);
+  COUNT_RENDER_STAT(numTriangles, countTriangles<DrawElementsIndirectCommand>(
+                                    topology, commands.m_mappedMemory,
+                                    drawCount));
   return *this;
 }
 
@@ -649,6 +935,52 @@ Extent2D RenderContext::getSwapchainSize() const {
   glfwGetFramebufferSize(glfwGetCurrentContext(), &w, &h);
   return {.width = uint32_t(w), .height = uint32_t(h)};
 }
+RenderContext::FramebufferCacheStats
+RenderContext::getFramebufferCacheStats() const {
+  auto stats = m_framebufferCacheStats;
+  stats.numCached = m_framebuffers.size();
+  return stats;
+}
+RenderContext::BindingStats RenderContext::getBindingStats() const {
+  return m_lastFrameBindingStats;
+}
+RenderContext::ProgramCacheStats RenderContext::getProgramCacheStats() const {
+  return m_programCacheStats;
+}
+const GPUProfiler &RenderContext::getGPUProfiler() const {
+  return m_gpuProfiler;
+}
+std::span<const RenderContext::ScopeRenderStats>
+RenderContext::getRenderStats() const {
+#ifdef RENDER_STATS
+  return m_lastFrameRenderStats;
+#else
+  return {};
+#endif
+}
+
+uint64_t RenderContext::getFrameIndex() const { return m_frameIndex; }
+bool RenderContext::isFrameComplete(uint64_t frameIndex) const {
+  return frameIndex < m_numCompletedFrames;
+}
+
+RenderContext &RenderContext::endFrame() {
+  _buildQueuedProgram();
+  _growUploadRing();
+  _advanceUploadRing();
+  m_frameFences.push_back({
+    .frameIndex = m_frameIndex++,
+    .fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0),
+  });
+  _pollFrameFences();
+  m_gpuProfiler.endFrame();
+#ifdef RENDER_STATS
+  assert(m_openScopes.empty());
+  m_lastFrameRenderStats = std::exchange(m_renderStats, {});
+#endif
+  m_lastFrameBindingStats = std::exchange(m_bindingStats, {});
+  return *this;
+}
 
 void RenderContext::_setupDebugCallback() {
 #ifdef _DEBUG
@@ -805,17 +1137,145 @@ Texture RenderContext::_createImmutableTexture(Extent2D extent, uint32_t depth,
   };
 }
 
-void RenderContext::_createFaceView(Texture &cubeMap, GLuint mipLevel,
-                                    GLuint layer, GLuint face) {
+std::size_t RenderContext::TextureViewKeyHash::operator()(
+  const TextureViewKey &key) const noexcept {
+  std::size_t hash{0};
+  hashCombine(hash, key.texture, key.mipLevel, key.layer, key.face);
+  return hash;
+}
+
+GLuint RenderContext::_getFaceView(const Texture &cubeMap, GLuint mipLevel,
+                                   GLuint layer, GLuint face) {
   assert(cubeMap.m_type == GL_TEXTURE_CUBE_MAP ||
          cubeMap.m_type == GL_TEXTURE_CUBE_MAP_ARRAY);
 
-  if (cubeMap.m_view != GL_NONE) glDeleteTextures(1, &cubeMap.m_view);
-  glGenTextures(1, &cubeMap.m_view);
+  const TextureViewKey key{
+    .texture = cubeMap.m_id,
+    .mipLevel = mipLevel,
+    .layer = layer,
+    .face = face,
+  };
+  if (const auto it = m_textureViews.find(key); it != m_textureViews.cend())
+    return it->second;
 
-  glTextureView(cubeMap.m_view, GL_TEXTURE_2D, cubeMap,
+  GLuint view;
+  glGenTextures(1, &view);
+  glTextureView(view, GL_TEXTURE_2D, cubeMap,
                 static_cast<GLenum>(cubeMap.m_pixelFormat), mipLevel, 1,
                 (layer * 6) + face, 1);
+
+  m_textureViews.emplace(key, view);
+  m_textureViewKeys[cubeMap.m_id].push_back(key);
+  return view;
+}
+void RenderContext::_releaseTextureViews(GLuint texture) {
+  const auto it = m_textureViewKeys.find(texture);
+  if (it == m_textureViewKeys.cend()) return;
+
+  for (const auto &key : it->second) {
+    if (const auto viewIt = m_textureViews.find(key);
+        viewIt != m_textureViews.cend()) {
+      glDeleteTextures(1, &viewIt->second);
+      m_textureViews.erase(viewIt);
+    }
+  }
+  m_textureViewKeys.erase(it);
+}
+
+std::size_t RenderContext::FramebufferKeyHash::operator()(
+  const FramebufferKey &key) const noexcept {
+  std::size_t hash{0};
+  for (uint32_t i{0}; i < key.numAttachments; ++i) {
+    const auto &[attachment, texture, mipLevel, layer, face] =
+      key.attachments[i];
+    hashCombine(hash, attachment, texture, mipLevel, layer, face);
+  }
+  return hash;
+}
+
+RenderContext::FramebufferKey
+RenderContext::FramebufferKey::make(const RenderingInfo &renderingInfo) {
+  FramebufferKey key;
+  const auto addAttachment = [&key](GLenum attachment,
+                                    const AttachmentInfo &info) {
+    assert(key.numAttachments < kMaxNumAttachments);
+    key.attachments[key.numAttachments++] = {
+      .attachment = attachment,
+      .texture = info.image.m_id,
+      .mipLevel = info.mipLevel,
+      .layer = info.layer.value_or(0),
+      .face = info.face.value_or(0),
+    };
+  };
+  if (renderingInfo.depthAttachment.has_value())
+    addAttachment(GL_DEPTH_ATTACHMENT, *renderingInfo.depthAttachment);
+  for (uint8_t i{0}; i < renderingInfo.colorAttachments.size(); ++i)
+    addAttachment(GL_COLOR_ATTACHMENT0 + i, renderingInfo.colorAttachments[i]);
+  return key;
+}
+GLuint RenderContext::_getFramebuffer(const RenderingInfo &renderingInfo) {
+  const auto key = FramebufferKey::make(renderingInfo);
+  if (const auto it = m_framebuffers.find(key); it != m_framebuffers.cend()) {
+    ++m_framebufferCacheStats.numHits;
+    return it->second;
+  }
+
+  ++m_framebufferCacheStats.numMisses;
+  const auto framebuffer = _createFramebuffer(renderingInfo);
+  m_framebuffers.emplace(key, framebuffer);
+  for (uint32_t i{0}; i < key.numAttachments; ++i) {
+    // A texture might be attached more than once (e.g. different layers).
+    auto &keys = m_textureFramebuffers[key.attachments[i].texture];
+    if (std::ranges::find(keys, key) == keys.cend()) keys.push_back(key);
+  }
+  return framebuffer;
+}
+GLuint RenderContext::_createFramebuffer(const RenderingInfo &renderingInfo) {
+  GLuint framebuffer;
+  glCreateFramebuffers(1, &framebuffer);
+  if (renderingInfo.depthAttachment.has_value()) {
+    _attachTexture(framebuffer, GL_DEPTH_ATTACHMENT,
+                   *renderingInfo.depthAttachment);
+  }
+  for (uint8_t i{0}; i < renderingInfo.colorAttachments.size(); ++i) {
+    _attachTexture(framebuffer, GL_COLOR_ATTACHMENT0 + i,
+                   renderingInfo.colorAttachments[i]);
+  }
+  if (const auto n = renderingInfo.colorAttachments.size(); n > 0) {
+    std::vector<GLenum> colorBuffers(n);
+    std::iota(colorBuffers.begin(), colorBuffers.end(), GL_COLOR_ATTACHMENT0);
+    glNamedFramebufferDrawBuffers(framebuffer, colorBuffers.size(),
+                                  colorBuffers.data());
+  }
+#ifdef _DEBUG
+  const auto status =
+    glCheckNamedFramebufferStatus(framebuffer, GL_DRAW_FRAMEBUFFER);
+  assert(GL_FRAMEBUFFER_COMPLETE == status);
+#endif
+  return framebuffer;
+}
+void RenderContext::_evictFramebuffers(GLuint texture) {
+  const auto it = m_textureFramebuffers.find(texture);
+  if (it == m_textureFramebuffers.cend()) return;
+
+  const auto keys = std::move(it->second);
+  m_textureFramebuffers.erase(it);
+  for (const auto &key : keys) {
+    if (const auto fbIt = m_framebuffers.find(key);
+        fbIt != m_framebuffers.cend()) {
+      glDeleteFramebuffers(1, &fbIt->second);
+      m_framebuffers.erase(fbIt);
+      ++m_framebufferCacheStats.numEvicted;
+    }
+    // Unlink from the other attachments (that outlive the framebuffer).
+    for (uint32_t i{0}; i < key.numAttachments; ++i) {
+      const auto otherIt =
+        m_textureFramebuffers.find(key.attachments[i].texture);
+      if (otherIt == m_textureFramebuffers.cend()) continue;
+      std::erase(otherIt->second, key);
+      if (otherIt->second.empty()) m_textureFramebuffers.erase(otherIt);
+    }
+  }
 }
 
 void RenderContext::_attachTexture(GLuint framebuffer, GLenum attachment,
@@ -824,11 +1284,11 @@ void RenderContext::_attachTexture(GLuint framebuffer, GLenum attachment,
 
   switch (image.m_type) {
   case GL_TEXTURE_CUBE_MAP:
-  case GL_TEXTURE_CUBE_MAP_ARRAY:
-    _createFaceView(image, mipLevel, maybeLayer.value_or(0),
-                    maybeFace.value_or(0));
-    glNamedFramebufferTexture(framebuffer, attachment, image.m_view, 0);
-    break;
+  case GL_TEXTURE_CUBE_MAP_ARRAY: {
+    const auto view = _getFaceView(image, mipLevel, maybeLayer.value_or(0),
+                                   maybeFace.value_or(0));
+    glNamedFramebufferTexture(framebuffer, attachment, view, 0);
+  } break;
 
   case GL_TEXTURE_2D:
     glNamedFramebufferTexture(framebuffer, attachment, image, mipLevel);
@@ -854,28 +1314,40 @@ GLuint RenderContext::_createShader(GLenum type, const std::string_view code) {
   const GLchar *strings{code.data()};
   glShaderSource(id, 1, &strings, nullptr);
   glCompileShader(id);
-
+  _checkShader(id);
+  return id;
+}
+void RenderContext::_checkShader(GLuint shader) {
   GLint status;
-  glGetShaderiv(id, GL_COMPILE_STATUS, &status);
+  glGetShaderiv(shader, GL_COMPILE_STATUS, &status);
   if (GL_FALSE == status) {
     GLint infoLogLength;
-    glGetShaderiv(id, GL_INFO_LOG_LENGTH, &infoLogLength);
+    glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &infoLogLength);
     assert(infoLogLength > 0);
     std::string infoLog("", infoLogLength);
-    glGetShaderInfoLog(id, infoLogLength, nullptr, infoLog.data());
+    glGetShaderInfoLog(shader, infoLogLength, nullptr, infoLog.data());
     throw std::runtime_error{infoLog};
   };
-  return id;
 }
 GLuint
 RenderContext::_createShaderProgram(std::initializer_list<GLuint> shaders) {
   const auto program = glCreateProgram();
-
+  _linkProgram(program, shaders);
+  _finishProgram(program, shaders);
+  return program;
+}
+void RenderContext::_linkProgram(GLuint program,
+                                 std::span<const GLuint> shaders) {
   for (auto shader : shaders)
     if (shader != GL_NONE) glAttachShader(program, shader);
 
-  glLinkProgram(program);
+  if (m_programCache)
+    glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
 
+  glLinkProgram(program);
+}
+void RenderContext::_finishProgram(GLuint program,
+                                   std::span<const GLuint> shaders) {
   GLint status;
   glGetProgramiv(program, GL_LINK_STATUS, &status);
   if (GL_FALSE == status) {
@@ -892,15 +1364,354 @@ RenderContext::_createShaderProgram(std::initializer_list<GLuint> shaders) {
       glDeleteShader(shader);
     }
   }
+  _reflectUniforms(program);
+}
+
+bool RenderContext::_pollProgram(GLuint program) {
+  auto &pending = m_pendingPrograms.at(program);
+  if (pending.shaders.empty()) return false; // Queued.
+
+#ifdef GL_KHR_parallel_shader_compile
+  GLint completed{GL_FALSE};
+  glGetProgramiv(program, GL_COMPLETION_STATUS_KHR, &completed);
+  if (GL_FALSE == completed) return false;
+#endif
+
+  try {
+    for (const auto shader : pending.shaders)
+      _checkShader(shader);
+    _finishProgram(program, pending.shaders);
+  } catch (...) {
+    _discardPendingProgram(program);
+    throw;
+  }
+  _storeProgram(pending.key, program);
+  m_pendingPrograms.erase(program);
+  return true;
+}
+void RenderContext::_buildQueuedProgram() {
+  if (m_programQueue.empty()) return;
+
+  ZoneScoped;
+  const ScopedTimer timer{m_programCacheStats.buildTime};
+
+  const auto program = m_programQueue.front();
+  auto &pending = m_pendingPrograms.at(program);
+  try {
+    for (const auto &[type, code] : pending.sources)
+      pending.shaders.push_back(_createShader(type, code));
+    _linkProgram(program, pending.shaders);
+    _finishProgram(program, pending.shaders);
+  } catch (...) {
+    _discardPendingProgram(program);
+    throw;
+  }
+  m_programQueue.pop_front();
+  _storeProgram(pending.key, program);
+  m_pendingPrograms.erase(program);
+}
+void RenderContext::_discardPendingProgram(GLuint program) {
+  if (const auto it = m_pendingPrograms.find(program);
+      it != m_pendingPrograms.cend()) {
+    for (const auto shader : it->second.shaders)
+      glDeleteShader(shader);
+    m_pendingPrograms.erase(it);
+  }
+  std::erase(m_programQueue, program);
+}
+
+ProgramKey RenderContext::_makeProgramKey(
+  std::initializer_list<std::string_view> sources) const {
+  ProgramKey key{
+    .hash = m_driverHash,
+    .driverHash = m_driverHash,
+    .sourceDigest = kFNVOffsetBasis,
+  };
+  for (const auto source : sources) {
+    hashCombine(key.hash, source);
+    // The size separates the sources ({"ab", ""} != {"a", "b"}).
+    const auto size = static_cast<uint64_t>(source.size());
+    fnv1a(key.sourceDigest, std::as_bytes(std::span{&size, 1}));
+    fnv1a(key.sourceDigest, std::as_bytes(std::span{source}));
+  }
+  return key;
+}
+GLuint RenderContext::_loadProgram(const ProgramKey &key) {
+  if (!m_programCache) return GL_NONE;
+
+  const auto binary = m_programCache->load(key);
+  if (!binary) {
+    ++m_programCacheStats.numMisses;
+    return GL_NONE;
+  }
+  const auto program = glCreateProgram();
+  glProgramBinary(program, binary->format, binary->data.data(),
+                  static_cast<GLsizei>(binary->data.size()));
 
+  GLint status;
+  glGetProgramiv(program, GL_LINK_STATUS, &status);
+  if (GL_FALSE == status) {
+    // e.g. Driver update, the binary will be replaced after compilation.
+    glDeleteProgram(program);
+    m_programCache->remove(key);
+    ++m_programCacheStats.numRejected;
+    ++m_programCacheStats.numMisses;
+    return GL_NONE;
+  }
+  ++m_programCacheStats.numHits;
+  _reflectUniforms(program);
   return program;
 }
+void RenderContext::_storeProgram(const ProgramKey &key, GLuint program) {
+  if (!m_programCache) return;
+
+  GLint length{0};
+  glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+  if (length <= 0) return;
+
+  ProgramBinary binary{.data = std::vector<char>(length)};
+  glGetProgramBinary(program, length, nullptr, &binary.format,
+                     binary.data.data());
+  m_programCache->store(key, binary);
+}
+
+void RenderContext::_reflectUniforms(GLuint program) {
+  GLint numUniforms{0};
+  glGetProgramInterfaceiv(program, GL_UNIFORM, GL_ACTIVE_RESOURCES,
+                          &numUniforms);
+  GLint maxNameLength{0};
+  glGetProgramInterfaceiv(program, GL_UNIFORM, GL_MAX_NAME_LENGTH,
+                          &maxNameLength);
+
+  UniformLocations locations;
+  locations.reserve(numUniforms);
+
+  std::string name(maxNameLength, '\0');
+  constexpr std::array<GLenum, 2> kProperties{GL_BLOCK_INDEX, GL_LOCATION};
+  for (GLint i{0}; i < numUniforms; ++i) {
+    std::array<GLint, kProperties.size()> values{};
+    glGetProgramResourceiv(program, GL_UNIFORM, i, kProperties.size(),
+                           kProperties.data(), values.size(), nullptr,
+                           values.data());
+    const auto [blockIndex, location] = values;
+    // Members of an uniform block do not have a location.
+    if (blockIndex != -1) continue;
+
+    GLsizei length{0};
+    glGetProgramResourceName(program, GL_UNIFORM, i, maxNameLength, &length,
+                             name.data());
+    const std::string_view uniformName{name.data(), std::size_t(length)};
+    locations.emplace(uniformName, location);
+    // An array is also accessible by its name without the subscript.
+    if (uniformName.ends_with("[0]")) {
+      locations.emplace(uniformName.substr(0, uniformName.size() - 3),
+                        location);
+    }
+  }
+  m_uniformLocations.insert_or_assign(program, std::move(locations));
+}
+GLint RenderContext::_getUniformLocation(GLuint program,
+                                         const std::string_view name) {
+  auto &locations = m_uniformLocations[program];
+  if (const auto it = locations.find(name); it != locations.cend())
+    return it->second;
+
+  // Not reflected (inactive, or the program has not been linked here),
+  // remember the answer so the driver is asked only once.
+  const auto location =
+    glGetUniformLocation(program, std::string{name}.c_str());
+  locations.emplace(name, location);
+  return location;
+}
+
+void RenderContext::_setUniform(GLuint program, GLint location, float f) {
+  if (location != -1) {
+    glProgramUniform1f(program, location, f);
+    COUNT_RENDER_STAT(numUniformUploads, 1);
+  }
+}
+void RenderContext::_setUniform(GLuint program, GLint location, int32_t i) {
+  if (location != -1) {
+    glProgramUniform1i(program, location, i);
+    COUNT_RENDER_STAT(numUniformUploads, 1);
+  }
+}
+void RenderContext::_setUniform(GLuint program, GLint location, uint32_t i) {
+  if (location != -1) {
+    glProgramUniform1ui(program, location, i);
+    COUNT_RENDER_STAT(numUniformUploads, 1);
+  }
+}
+void RenderContext::_setUniform(GLuint program, GLint location,
+                                const glm::vec3 &v) {
+  if (location != -1) {
+    glProgramUniform3fv(program, location, 1, glm::value_ptr(v));
+    COUNT_RENDER_STAT(numUniformUploads, 1);
+  }
+}
+void RenderContext::_setUniform(GLuint program, GLint location,
+                                const glm::vec4 &v) {
+  if (location != -1) {
+    glProgramUniform4fv(program, location, 1, glm::value_ptr(v));
+    COUNT_RENDER_STAT(numUniformUploads, 1);
+  }
+}
+void RenderContext::_setUniform(GLuint program, GLint location,
+                                const glm::mat3 &m) {
+  if (location != -1) {
+    glProgramUniformMatrix3fv(program, location, 1, GL_FALSE,
+                              glm::value_ptr(m));
+    COUNT_RENDER_STAT(numUniformUploads, 1);
+  }
+}
+void RenderContext::_setUniform(GLuint program, GLint location,
+                                const glm::mat4 &m) {
+  if (location != -1) {
+    glProgramUniformMatrix4fv(program, location, 1, GL_FALSE,
+                              glm::value_ptr(m));
+    COUNT_RENDER_STAT(numUniformUploads, 1);
+  }
+}
+
+void RenderContext::_createUploadRing(GLsizeiptr frameSize) {
+  auto &ring = m_uploadRing;
+
+  GLint uniformAlignment{1};
+  glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &uniformAlignment);
+  GLint storageAlignment{1};
+  glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &storageAlignment);
+  ring.alignment = std::max(uniformAlignment, storageAlignment);
+  ring.frameSize = frameSize;
+
+  const auto size = frameSize * UploadRing::kNumFramesInFlight;
+  constexpr GLbitfield kFlags{GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT |
+                              GL_MAP_COHERENT_BIT};
+  GLuint buffer;
+  glCreateBuffers(1, &buffer);
+  glNamedBufferStorage(buffer, size, nullptr, kFlags);
+  ring.buffer = Buffer{buffer, size};
+  ring.buffer.m_mappedMemory = glMapNamedBufferRange(buffer, 0, size, kFlags);
+  if (!ring.buffer.isMapped()) throw std::runtime_error{"Upload ring mapping"};
+}
+void RenderContext::_destroyUploadRing() {
+  for (auto &fence : m_uploadRing.fences) {
+    if (fence) glDeleteSync(fence);
+    fence = nullptr;
+  }
+  unmap(m_uploadRing.buffer).destroy(m_uploadRing.buffer);
+}
+void RenderContext::_growUploadRing() {
+  auto &ring = m_uploadRing;
+  for (auto &buffer : ring.overflowBuffers)
+    unmap(buffer).destroy(buffer);
+  ring.overflowBuffers.clear();
+  if (ring.highWaterMark <= ring.frameSize) return;
+
+  ZoneScoped;
+  const auto frameSize = static_cast<GLsizeiptr>(
+    std::bit_ceil(static_cast<uint64_t>(ring.highWaterMark)));
+  SPDLOG_WARN("Upload ring exhausted ({} of {} bytes), growing to {} bytes",
+              ring.highWaterMark, ring.frameSize, frameSize);
+  // The old buffer is released once the GPU is done with it.
+  _destroyUploadRing();
+  _createUploadRing(frameSize);
+}
+void RenderContext::_advanceUploadRing() {
+  ZoneScoped;
+  auto &ring = m_uploadRing;
+
+  ring.fences[ring.frameIndex] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  ring.frameIndex = (ring.frameIndex + 1) % UploadRing::kNumFramesInFlight;
+  ring.head = 0;
+  ring.highWaterMark = 0;
+
+  // Wait until the GPU is done with the region that is about to be reused.
+  if (auto &fence = ring.fences[ring.frameIndex]; fence) {
+    constexpr GLuint64 kTimeout{1'000'000}; // 1ms (in nanoseconds)
+    GLbitfield flags{GL_SYNC_FLUSH_COMMANDS_BIT};
+    for (;;) {
+      const auto result = glClientWaitSync(fence, flags, kTimeout);
+      if (result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED ||
+          result == GL_WAIT_FAILED) {
+        break;
+      }
+      flags = 0;
+    }
+    glDeleteSync(fence);
+    fence = nullptr;
+  }
+}
+
+void RenderContext::_pollFrameFences() {
+  while (!m_frameFences.empty()) {
+    const auto [frameIndex, fence] = m_frameFences.front();
+    const auto result = glClientWaitSync(fence, 0, 0);
+    if (result == GL_TIMEOUT_EXPIRED) break;
+
+    glDeleteSync(fence);
+    m_numCompletedFrames = frameIndex + 1;
+    m_frameFences.pop_front();
+  }
+}
+
+void RenderContext::_flushTextureBindings() {
+  if (m_firstDirtyUnit > m_lastDirtyUnit) return;
+
+  // Binds [first, last] in one call, where first/last are the outermost units
+  // that differ (units in between are rebound, which is harmless).
+  const auto flush = [this](std::vector<GLuint> &bound,
+                            const std::vector<GLuint> &pending,
+                            auto &&multiBind) {
+    auto first = m_firstDirtyUnit;
+    auto last = m_lastDirtyUnit;
+    while (first <= last && bound[first] == pending[first])
+      ++first;
+    while (last > first && bound[last] == pending[last])
+      --last;
+    if (first > last) return;
+
+    const auto count = static_cast<GLsizei>(last - first + 1);
+    multiBind(first, count, pending.data() + first);
+    std::copy_n(pending.cbegin() + first, count, bound.begin() + first);
+    ++m_bindingStats.numCalls;
+  };
+  flush(m_boundTextures, m_pendingTextures,
+        [](GLuint first, GLsizei count, const GLuint *textures) {
+          glBindTextures(first, count, textures);
+        });
+  flush(m_boundSamplers, m_pendingSamplers,
+        [](GLuint first, GLsizei count, const GLuint *samplers) {
+          glBindSamplers(first, count, samplers);
+        });
+
+  m_firstDirtyUnit = ~0u;
+  m_lastDirtyUnit = 0;
+}
+void RenderContext::_forgetBindings(const Texture &texture) {
+  // A deleted texture is unbound (by the GL) from every unit.
+  const GLuint id = texture;
+  std::replace(m_boundTextures.begin(), m_boundTextures.end(), id,
+               GLuint{GL_NONE});
+  std::replace(m_pendingTextures.begin(), m_pendingTextures.end(), id,
+               GLuint{GL_NONE});
+  for (auto &binding : m_imageUnits)
+    if (binding.texture == id) binding = {};
+}
+void RenderContext::_forgetBindings(const Buffer &buffer) {
+  const auto forget = [id = GLuint(buffer)](BufferBinding &binding) {
+    if (binding.buffer == id) binding = {};
+  };
+  std::ranges::for_each(m_uniformBuffers, forget);
+  std::ranges::for_each(m_storageBuffers, forget);
+  if (m_drawIndirectBuffer == GLuint(buffer)) m_drawIndirectBuffer = GL_NONE;
+}
 
 void RenderContext::_setShaderProgram(GLuint program) {
   assert(program != GL_NONE);
   if (auto &current = m_currentPipeline.m_program; current != program) {
     glUseProgram(program);
     current = program;
+    COUNT_RENDER_STAT(numProgramSwitches, 1);
   }
 }
 void RenderContext::_setVertexArray(GLuint vao) {
@@ -909,6 +1720,7 @@ void RenderContext::_setVertexArray(GLuint vao) {
   if (auto &current = m_currentPipeline.m_vertexArray; vao != current) {
     glBindVertexArray(vao);
     current = vao;
+    COUNT_RENDER_STAT(numVertexArraySwitches, 1);
   }
 }
 void RenderContext::_setVertexBuffer(const VertexBuffer &vertexBuffer) {
@@ -923,6 +1735,46 @@ void RenderContext::_setIndexBuffer(const IndexBuffer &indexBuffer) {
   glVertexArrayElementBuffer(vao, indexBuffer.m_id);
 }
 
+const void *RenderContext::_setDrawIndirectBuffer(const Buffer &commands) {
+  assert(commands);
+  if (m_drawIndirectBuffer != commands.m_id) {
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, commands.m_id);
+    m_drawIndirectBuffer = commands.m_id;
+  }
+  return reinterpret_cast<const void *>(commands.m_offset);
+}
+
+void RenderContext::_pushDebugScope(const std::string_view name) {
+  m_gpuProfiler.beginScope(name);
+#ifdef RENDER_STATS
+  // Scopes with the same name (at the same level) share stats.
+  const auto depth = static_cast<uint32_t>(m_openScopes.size());
+  auto it = std::ranges::find_if(m_renderStats, [name, depth](const auto &s) {
+    return s.name == name && s.depth == depth + 1;
+  });
+  if (it == m_renderStats.end()) {
+    (void)_getRenderStats(); // The unscoped entry has to come first.
+    m_renderStats.push_back({.name = std::string{name}, .depth = depth + 1});
+    it = std::prev(m_renderStats.end());
+  }
+  m_openScopes.push_back(
+    static_cast<uint32_t>(std::distance(m_renderStats.begin(), it)));
+#endif
+}
+void RenderContext::_popDebugScope() {
+#ifdef RENDER_STATS
+  assert(!m_openScopes.empty());
+  m_openScopes.pop_back();
+#endif
+  m_gpuProfiler.endScope();
+}
+#ifdef RENDER_STATS
+RenderContext::RenderStats &RenderContext::_getRenderStats() {
+  if (m_renderStats.empty()) m_renderStats.push_back({.name = "(unscoped)"});
+  return m_renderStats[m_openScopes.empty() ? 0 : m_openScopes.back()].stats;
+}
+#endif
+
 void RenderContext::_setDepthTest(bool enabled, CompareOp depthFunc) {
   auto &current = m_currentPipeline.m_depthStencilState;
   if (enabled != current.depthTest) {
@@ -1030,5 +1882,9 @@ void RenderContext::_setBlendState(GLuint index, const BlendState &state) {
 
 DebugMarker::DebugMarker(const std::string_view name) {
   glPushDebugGroup(GL_DEBUG_SOURCE_APPLICATION, 0, -1, name.data());
+  if (g_renderContext) g_renderContext->_pushDebugScope(name);
+}
+DebugMarker::~DebugMarker() {
+  if (g_renderContext) g_renderContext->_popDebugScope();
+  glPopDebugGroup();
 }
-DebugMarker::~DebugMarker() { glPopDebugGroup(); }
@@ -5,8 +5,14 @@
 #include "Texture.hpp"
 #include "VertexAttributes.hpp"
 #include "GraphicsPipeline.hpp"
+#include "ProgramCache.hpp"
+#include "GPUProfiler.hpp"
+#include "Hash.hpp"
 #include "glm/glm.hpp"
 #include <variant>
+#include <array>
+#include <span>
+#include <deque>
 #include <string_view>
 #include <unordered_map>
 
@@ -60,9 +66,46 @@ struct GeometryInfo {
   auto operator<=>(const GeometryInfo &) const = default;
 };
 
+// Layouts required by glMultiDraw{Arrays|Elements}Indirect.
+struct DrawArraysIndirectCommand {
+  uint32_t count{0};
+  uint32_t instanceCount{1};
+  uint32_t first{0};
+  uint32_t baseInstance{0};
+};
+static_assert(sizeof(DrawArraysIndirectCommand) == 16);
+struct DrawElementsIndirectCommand {
+  uint32_t count{0};
+  uint32_t instanceCount{1};
+  uint32_t firstIndex{0};
+  int32_t baseVertex{0};
+  uint32_t baseInstance{0};
+};
+static_assert(sizeof(DrawElementsIndirectCommand) == 20);
+
+// @brief Uniform location resolved once (see RenderContext::getUniformHandle).
+template <typename T> class UniformHandle {
+  friend class RenderContext;
+
+public:
+  UniformHandle() = default;
+
+  [[nodiscard]] bool isValid() const { return m_location != -1; }
+  explicit operator bool() const { return isValid(); }
+
+private:
+  UniformHandle(GLuint program, GLint location)
+      : m_program{program}, m_location{location} {}
+
+private:
+  GLuint m_program{GL_NONE};
+  GLint m_location{-1};
+};
+
 class RenderContext {
 public:
-  RenderContext();
+  // @param programCacheDir Where to keep program binaries (empty = disabled)
+  explicit RenderContext(const std::filesystem::path &programCacheDir = {});
   RenderContext(const RenderContext &) = delete;
   RenderContext(RenderContext &&) noexcept = delete;
   ~RenderContext();
@@ -79,6 +122,22 @@ public:
                                                 const void *data = nullptr);
   [[nodiscard]] IndexBuffer createIndexBuffer(IndexType, int64_t capacity,
                                               const void *data = nullptr);
+  /*
+   * @brief Suballocates from the per-frame upload ring (persistently mapped).
+   * When the region of the current frame is full, falls back to a dedicated
+   * buffer, and the ring grows in endFrame.
+   * @return A view, valid until the end of the current frame (see endFrame)
+   * @remark Write with upload(), destroy() only drops the view
+   */
+  [[nodiscard]] Buffer createStreamBuffer(GLsizeiptr size);
+  /*
+   * @return A view of [offset, offset + size) of the given buffer
+   * @remark The buffer must outlive the view, destroy() only drops the view
+   */
+  [[nodiscard]] Buffer createBufferView(const Buffer &, GLintptr offset,
+                                        GLsizeiptr size);
+  // @return Offset alignment that satisfies both UBO and SSBO bindings.
+  [[nodiscard]] GLsizeiptr getBufferOffsetAlignment() const;
 
   [[nodiscard]] GLuint getVertexArray(const VertexAttributes &);
 
@@ -87,6 +146,19 @@ public:
     std::optional<const std::string_view> geomCode = std::nullopt);
   [[nodiscard]] GLuint createComputeProgram(const std::string_view code);
 
+  /*
+   * @brief Same as createGraphicsProgram, but does not wait for the driver.
+   * Uses GL_KHR_parallel_shader_compile if available, otherwise the program is
+   * built later, from a queue processed (one program at a time) in endFrame.
+   * @remark Poll with isProgramReady before use
+   */
+  [[nodiscard]] GLuint createGraphicsProgramAsync(
+    const std::string_view vertCode, const std::string_view fragCode,
+    std::optional<const std::string_view> geomCode = std::nullopt);
+  // @throws std::runtime_error if the program failed to compile/link
+  [[nodiscard]] bool isProgramReady(GLuint program);
+  [[nodiscard]] bool isProgramReady(const GraphicsPipeline &);
+
   [[nodiscard]] Texture createTexture2D(Extent2D extent, PixelFormat,
                                         uint32_t numMipLevels = 1u,
                                         uint32_t numLayers = 0u);
@@ -153,6 +225,24 @@ public:
   RenderContext &setUniformMat3(const std::string_view name, const glm::mat3 &);
   RenderContext &setUniformMat4(const std::string_view name, const glm::mat4 &);
 
+  // @remark T = float, int32_t, uint32_t, glm::vec3, glm::vec4, glm::mat3 or
+  // glm::mat4
+  template <typename T>
+  [[nodiscard]] UniformHandle<T> getUniformHandle(GLuint program,
+                                                  const std::string_view name) {
+    return {program, _getUniformLocation(program, name)};
+  }
+  template <typename T>
+  [[nodiscard]] UniformHandle<T> getUniformHandle(const GraphicsPipeline &gp,
+                                                  const std::string_view name) {
+    return getUniformHandle<T>(gp.m_program, name);
+  }
+  template <typename T>
+  RenderContext &setUniform(const UniformHandle<T> &handle, const T &v) {
+    _setUniform(handle.m_program, handle.m_location, v);
+    return *this;
+  }
+
   // ---
 
   RenderContext &setViewport(const Rect2D &);
@@ -173,9 +263,69 @@ public:
   RenderContext &draw(OptionalReference<const VertexBuffer>,
                       OptionalReference<const IndexBuffer>,
                       const GeometryInfo &, uint32_t numInstances = 1);
+  // @param commands Tightly packed array of DrawArraysIndirectCommand,
+  // gl_DrawID goes from 0 to drawCount - 1.
+  RenderContext &multiDrawIndirect(const VertexBuffer &, PrimitiveTopology,
+                                   const Buffer &commands, uint32_t drawCount);
+  // @param commands Tightly packed array of DrawElementsIndirectCommand.
+  RenderContext &multiDrawIndirect(const VertexBuffer &, const IndexBuffer &,
+                                   PrimitiveTopology, const Buffer &commands,
+                                   uint32_t drawCount);
 
   [[nodiscard]] Extent2D getSwapchainSize() const;
 
+  struct FramebufferCacheStats {
+    uint64_t numHits{0};
+    uint64_t numMisses{0};
+    uint64_t numEvicted{0};
+    std::size_t numCached{0};
+  };
+  [[nodiscard]] FramebufferCacheStats getFramebufferCacheStats() const;
+
+  struct BindingStats {
+    uint32_t numIssued{0}; // Binds that changed the state.
+    uint32_t numElided{0}; // Redundant binds (skipped).
+    uint32_t numCalls{0};  // GL calls (one multi-bind covers many units).
+  };
+  // @return Stats of the previous frame.
+  [[nodiscard]] BindingStats getBindingStats() const;
+
+  struct ProgramCacheStats {
+    uint32_t numHits{0};
+    uint32_t numMisses{0};
+    uint32_t numRejected{0}; // Invalid/stale binaries (also a miss).
+    float buildTime{0.0f};   // Time spent in create*Program (in ms).
+  };
+  [[nodiscard]] ProgramCacheStats getProgramCacheStats() const;
+
+  // @brief GPU time of the DebugMarker scopes.
+  [[nodiscard]] const GPUProfiler &getGPUProfiler() const;
+
+  struct RenderStats {
+    uint32_t numDrawCalls{0};
+    uint64_t numTriangles{0};
+    uint32_t numProgramSwitches{0};
+    uint32_t numVertexArraySwitches{0};
+    uint32_t numTextureBinds{0}; // Issued (not elided) ones.
+    uint32_t numUniformUploads{0};
+  };
+  struct ScopeRenderStats {
+    std::string name;
+    uint32_t depth{0};
+    RenderStats stats; // Excludes nested scopes.
+  };
+  // @return Stats of the previous frame, per DebugMarker scope (the first one
+  // gathers everything outside of scopes). Empty without RENDER_STATS.
+  [[nodiscard]] std::span<const ScopeRenderStats> getRenderStats() const;
+
+  // @return Index of the frame that is being recorded (advanced by endFrame).
+  [[nodiscard]] uint64_t getFrameIndex() const;
+  // @return true if the GPU has finished all commands of the given frame.
+  [[nodiscard]] bool isFrameComplete(uint64_t frameIndex) const;
+
+  // @brief Closes the per-frame statistics and fences the frame.
+  RenderContext &endFrame();
+
   struct ResourceDeleter {
     void operator()(auto *ptr) {
       m_renderContext.destroy(*ptr);
@@ -198,19 +348,60 @@ public:
                                                 uint32_t numMipLevels,
                                                 uint32_t numLayers);
 
-  void _createFaceView(Texture &cubeMap, GLuint mipLevel, GLuint layer,
-                       GLuint face);
+  // @return 2D view of a cubemap face, owned by the cache (see destroy)
+  [[nodiscard]] GLuint _getFaceView(const Texture &cubeMap, GLuint mipLevel,
+                                    GLuint layer, GLuint face);
+  void _releaseTextureViews(GLuint texture);
   void _attachTexture(GLuint framebuffer, GLenum attachment,
                       const AttachmentInfo &);
 
+  [[nodiscard]] GLuint _getFramebuffer(const RenderingInfo &);
+  [[nodiscard]] GLuint _createFramebuffer(const RenderingInfo &);
+  void _evictFramebuffers(GLuint texture);
+
   [[nodiscard]] GLuint _createShader(GLenum type, const std::string_view code);
+  void _checkShader(GLuint shader);
   [[nodiscard]] GLuint
   _createShaderProgram(std::initializer_list<GLuint> shaders);
+  void _linkProgram(GLuint program, std::span<const GLuint> shaders);
+  void _finishProgram(GLuint program, std::span<const GLuint> shaders);
+
+  // @return true when the pending program has been finished
+  [[nodiscard]] bool _pollProgram(GLuint program);
+  void _buildQueuedProgram();
+  void _discardPendingProgram(GLuint program);
+
+  [[nodiscard]] ProgramKey
+  _makeProgramKey(std::initializer_list<std::string_view> sources) const;
+  [[nodiscard]] GLuint _loadProgram(const ProgramKey &);
+  void _storeProgram(const ProgramKey &, GLuint program);
+
+  void _reflectUniforms(GLuint program);
+  [[nodiscard]] GLint _getUniformLocation(GLuint program,
+                                          const std::string_view name);
+
+  void _setUniform(GLuint program, GLint location, float);
+  void _setUniform(GLuint program, GLint location, int32_t);
+  void _setUniform(GLuint program, GLint location, uint32_t);
+  void _setUniform(GLuint program, GLint location, const glm::vec3 &);
+  void _setUniform(GLuint program, GLint location, const glm::vec4 &);
+  void _setUniform(GLuint program, GLint location, const glm::mat3 &);
+  void _setUniform(GLuint program, GLint location, const glm::mat4 &);
 
   void _setShaderProgram(GLuint);
   void _setVertexArray(GLuint);
   void _setVertexBuffer(const VertexBuffer &);
   void _setIndexBuffer(const IndexBuffer &);
+  // @return Offset of the commands (for glMultiDraw*Indirect).
+  const void *_setDrawIndirectBuffer(const Buffer &commands);
+
+  // Called by DebugMarker.
+  void _pushDebugScope(const std::string_view name);
+  void _popDebugScope();
+#ifdef RENDER_STATS
+  // @return Stats of the innermost scope.
+  [[nodiscard]] RenderStats &_getRenderStats();
+#endif
 
   void _setDepthTest(bool enabled, CompareOp);
   void _setDepthWrite(bool enabled);
@@ -223,10 +414,149 @@ public:
 
   void _setBlendState(GLuint index, const BlendState &);
 
+  void _createUploadRing(GLsizeiptr frameSize);
+  void _destroyUploadRing();
+  // Recreates the ring if the current frame has overflowed its region.
+  void _growUploadRing();
+  void _advanceUploadRing();
+  // Pops signalled fences (without waiting).
+  void _pollFrameFences();
+
+  void _flushTextureBindings();
+  void _forgetBindings(const Texture &);
+  void _forgetBindings(const Buffer &);
+
 private:
   GLuint m_dummyVAO{GL_NONE};
   std::unordered_map<std::size_t, GLuint> m_vertexArrays;
 
+  struct TextureViewKey {
+    GLuint texture{GL_NONE};
+    GLuint mipLevel{0};
+    GLuint layer{0};
+    GLuint face{0};
+
+    bool operator==(const TextureViewKey &) const = default;
+  };
+  struct TextureViewKeyHash {
+    std::size_t operator()(const TextureViewKey &) const noexcept;
+  };
+  std::unordered_map<TextureViewKey, GLuint, TextureViewKeyHash> m_textureViews;
+  // Texture id -> keys of its views.
+  std::unordered_map<GLuint, std::vector<TextureViewKey>> m_textureViewKeys;
+
+  struct FramebufferAttachment {
+    GLenum attachment{GL_NONE};
+    GLuint texture{GL_NONE};
+    uint32_t mipLevel{0};
+    uint32_t layer{0};
+    uint32_t face{0};
+
+    bool operator==(const FramebufferAttachment &) const = default;
+  };
+  // The attachment set (depth + up to 8 color attachments).
+  struct FramebufferKey {
+    static constexpr uint32_t kMaxNumAttachments{9};
+    std::array<FramebufferAttachment, kMaxNumAttachments> attachments{};
+    uint32_t numAttachments{0};
+
+    [[nodiscard]] static FramebufferKey make(const RenderingInfo &);
+
+    bool operator==(const FramebufferKey &) const = default;
+  };
+  struct FramebufferKeyHash {
+    std::size_t operator()(const FramebufferKey &) const noexcept;
+  };
+  std::unordered_map<FramebufferKey, GLuint, FramebufferKeyHash>
+    m_framebuffers;
+  // Texture id -> keys of framebuffers that reference it.
+  std::unordered_map<GLuint, std::vector<FramebufferKey>> m_textureFramebuffers;
+  FramebufferCacheStats m_framebufferCacheStats;
+
+  std::optional<ProgramCache> m_programCache;
+  std::size_t m_driverHash{0}; // vendor + renderer + version
+  ProgramCacheStats m_programCacheStats;
+
+  bool m_parallelShaderCompile{false};
+  struct PendingProgram {
+    ProgramKey key;
+    // Compiling (GL_KHR_parallel_shader_compile) ...
+    std::vector<GLuint> shaders;
+    // ... or waiting in m_programQueue.
+    std::vector<std::pair<GLenum, std::string>> sources;
+  };
+  std::unordered_map<GLuint, PendingProgram> m_pendingPrograms;
+  std::deque<GLuint> m_programQueue;
+
+  // Key = program id, filled at link time (and lazily for unknown names).
+  using UniformLocations =
+    std::unordered_map<std::string, GLint, StringHash, std::equal_to<>>;
+  std::unordered_map<GLuint, UniformLocations> m_uniformLocations;
+
+  // Texture and sampler binds are deferred until the next draw/dispatch, then
+  // contiguous units go out in a single glBindTextures/glBindSamplers call.
+  std::vector<GLuint> m_boundTextures, m_pendingTextures;
+  std::vector<GLuint> m_boundSamplers, m_pendingSamplers;
+  GLuint m_firstDirtyUnit{~0u}, m_lastDirtyUnit{0};
+
+  struct ImageBinding {
+    GLuint texture{GL_NONE};
+    GLint mipLevel{0};
+    GLenum access{GL_NONE};
+    GLenum format{GL_NONE};
+
+    auto operator<=>(const ImageBinding &) const = default;
+  };
+  std::vector<ImageBinding> m_imageUnits;
+
+  struct BufferBinding {
+    GLuint buffer{GL_NONE};
+    GLintptr offset{0};
+    GLsizeiptr size{0};
+
+    auto operator<=>(const BufferBinding &) const = default;
+  };
+  std::vector<BufferBinding> m_uniformBuffers, m_storageBuffers;
+  GLuint m_drawIndirectBuffer{GL_NONE};
+
+  BindingStats m_bindingStats, m_lastFrameBindingStats;
+
+  // One region per frame in flight, a region is reused after its fence
+  // signals.
+  struct UploadRing {
+    static constexpr uint32_t kNumFramesInFlight{3};
+
+    Buffer buffer;
+    GLsizeiptr frameSize{0};
+    GLsizeiptr alignment{1};
+
+    uint32_t frameIndex{0};
+    GLsizeiptr head{0}; // Relative to the current region.
+    // Bytes requested in the current frame (those that did not fit included).
+    GLsizeiptr highWaterMark{0};
+    std::array<GLsync, kNumFramesInFlight> fences{};
+
+    // Created (one per allocation) when the region is full, destroyed in
+    // endFrame (GL defers the deletion until the GPU is done with them).
+    std::vector<Buffer> overflowBuffers;
+  };
+  UploadRing m_uploadRing;
+
+  uint64_t m_frameIndex{0};
+  uint64_t m_numCompletedFrames{0}; // Frames [0, n) are done.
+  struct FrameFence {
+    uint64_t frameIndex;
+    GLsync fence;
+  };
+  std::deque<FrameFence> m_frameFences;
+
+  GPUProfiler m_gpuProfiler;
+
+#ifdef RENDER_STATS
+  std::vector<ScopeRenderStats> m_renderStats, m_lastFrameRenderStats;
+  std::vector<uint32_t> m_openScopes; // Indices into m_renderStats.
+#endif
+
   GraphicsPipeline m_currentPipeline{};
   bool m_renderingStarted{false};
 };
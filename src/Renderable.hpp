@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Mesh.hpp"
+#include <memory_resource>
 
 struct Renderable {
   const Mesh &mesh;
@@ -15,6 +16,8 @@ struct Renderable {
 };
 
 using Renderables = std::vector<Renderable>;
+// Per-frame lists are allocated from the frame arena (see WorldRenderer).
+using RenderableList = std::pmr::vector<const Renderable *>;
 
 [[nodiscard]] inline bool isTransparent(const Renderable *renderable) {
   return renderable->material.getBlendMode() == BlendMode::Transparent;
@@ -1,13 +1,11 @@
 #include "ShadowCascadesBuilder.hpp"
 #include "glm/gtc/matrix_transform.hpp"
-#include <array>
 
 // https://johanmedestrom.wordpress.com/2016/03/18/opengl-cascaded-shadow-maps/
 
 namespace {
 
 using Splits = std::vector<float>;
-using FrustumCorners = std::array<glm::vec3, 8>;
 
 [[nodiscard]] auto buildCascadeSplits(uint32_t numCascades, float lambda,
                                       float near, float clipRange) {
@@ -92,12 +90,9 @@ void eliminateShimmering(glm::mat4 &projection, const glm::mat4 &view,
   projection[3] += roundOffset;
 }
 
-[[nodiscard]] auto buildDirLightMatrix(const glm::mat4 &inversedViewProj,
+[[nodiscard]] auto buildDirLightMatrix(const FrustumCorners &frustumCorners,
                                        const glm::vec3 &lightDirection,
-                                       uint32_t shadowMapSize, float splitDist,
-                                       float lastSplitDist) {
-  const auto frustumCorners =
-    buildFrustumCorners(inversedViewProj, splitDist, lastSplitDist);
+                                       uint32_t shadowMapSize) {
   const auto [center, radius] = measureFrustum(frustumCorners);
 
   const auto maxExtents = glm::vec3{radius};
@@ -126,11 +121,13 @@ std::vector<Cascade> buildCascades(const PerspectiveCamera &camera,
   std::vector<Cascade> cascades(numCascades);
   for (uint32_t i{0}; i < cascades.size(); ++i) {
     const auto splitDist = cascadeSplits[i];
+    const auto frustumCorners =
+      buildFrustumCorners(inversedViewProj, splitDist, lastSplitDist);
     cascades[i] = {
       .splitDepth = (camera.getNear() + splitDist * clipRange) * -1.0f,
       .viewProjMatrix =
-        buildDirLightMatrix(inversedViewProj, lightDirection, shadowMapSize,
-                            splitDist, lastSplitDist),
+        buildDirLightMatrix(frustumCorners, lightDirection, shadowMapSize),
+      .frustumCorners = frustumCorners,
     };
     lastSplitDist = splitDist;
   }
@@ -1,11 +1,16 @@
 #pragma once
 
 #include "PerspectiveCamera.hpp"
+#include <array>
 #include <vector>
 
+// Near (TL, TR, BR, BL), then far (in the same order).
+using FrustumCorners = std::array<glm::vec3, 8>;
+
 struct Cascade {
   float splitDepth;
   glm::mat4 viewProjMatrix;
+  FrustumCorners frustumCorners; // Of the camera slice (world-space).
 };
 
 [[nodiscard]] std::vector<Cascade>
@@ -0,0 +1,152 @@
+#include "ShadowCasterCulling.hpp"
+#include "glm/common.hpp"
+#include "glm/geometric.hpp"
+#include <algorithm>
+#include <optional>
+#include <limits>
+#include <cassert>
+
+namespace {
+
+// Faces of FrustumCorners, in any winding (oriented by the centroid).
+constexpr uint32_t kFaces[6][4]{
+  {0, 1, 2, 3}, // Near
+  {4, 5, 6, 7}, // Far
+  {0, 3, 7, 4}, // Left
+  {1, 2, 6, 5}, // Right
+  {0, 1, 5, 4}, // Top
+  {3, 2, 6, 7}, // Bottom
+};
+struct Edge {
+  uint32_t a, b;
+  uint32_t faces[2];
+};
+constexpr Edge kEdges[12]{
+  {0, 1, {0, 4}}, {1, 2, {0, 3}}, {2, 3, {0, 5}}, {3, 0, {0, 2}},
+  {4, 5, {1, 4}}, {5, 6, {1, 3}}, {6, 7, {1, 5}}, {7, 4, {1, 2}},
+  {0, 4, {2, 4}}, {1, 5, {3, 4}}, {2, 6, {3, 5}}, {3, 7, {2, 5}},
+};
+
+// @return A plane through the point, facing the centroid (std::nullopt if the
+// normal is degenerate).
+[[nodiscard]] std::optional<Plane> makePlane(const glm::vec3 &normal,
+                                             const glm::vec3 &point,
+                                             const glm::vec3 &centroid) {
+  constexpr auto kEpsilon = 1e-6f;
+  const auto length = glm::length(normal);
+  if (length < kEpsilon) return std::nullopt;
+
+  Plane plane{.normal = normal / length};
+  plane.distance = -glm::dot(plane.normal, point);
+  if (plane.distanceTo(centroid) < 0) {
+    plane.normal = -plane.normal;
+    plane.distance = -plane.distance;
+  }
+  return plane;
+}
+
+// Frustum::testAABB: outside of a plane if the positive vertex is.
+[[nodiscard]] bool isOutside(const AABB &aabb, const Plane &plane) {
+  const glm::vec3 pv{
+    plane.normal.x >= 0 ? aabb.max.x : aabb.min.x,
+    plane.normal.y >= 0 ? aabb.max.y : aabb.min.y,
+    plane.normal.z >= 0 ? aabb.max.z : aabb.min.z,
+  };
+  return plane.distanceTo(pv) < 0;
+}
+
+} // namespace
+
+//
+// ShadowCasterCulling class:
+//
+
+ShadowCasterCulling::ShadowCasterCulling(const PerspectiveCamera &camera,
+                                         std::span<const Cascade> cascades,
+                                         const glm::vec3 &lightDirection,
+                                         const AABB &receiverBounds)
+    : m_viewMatrix{camera.getView()},
+      m_lightDirection{glm::normalize(lightDirection)},
+      m_receiverBounds{receiverBounds},
+      m_numCascades{static_cast<uint32_t>(cascades.size())} {
+  assert(m_numCascades <= kMaxNumCascades);
+
+  for (uint32_t i{0}; i < m_numCascades; ++i) {
+    const auto &corners = cascades[i].frustumCorners;
+    glm::vec3 centroid{0.0f};
+    for (const auto &p : corners)
+      centroid += p;
+    centroid /= corners.size();
+
+    auto &volume = m_volumes[i];
+    // A caster is behind a face for good if moving along the light does not
+    // bring it closer (the other faces are swept away).
+    bool keepFace[6]{};
+    for (uint32_t f{0}; f < 6; ++f) {
+      const auto [a, b, c, d] = kFaces[f];
+      const auto plane = makePlane(
+        glm::cross(corners[c] - corners[a], corners[d] - corners[b]),
+        corners[a], centroid);
+      if (plane && glm::dot(plane->normal, m_lightDirection) <= 0.0f) {
+        keepFace[f] = true;
+        volume.planes[volume.numPlanes++] = *plane;
+      }
+    }
+    // The sides of the extrusion: through the silhouette edges, along the
+    // light.
+    for (const auto &[a, b, faces] : kEdges) {
+      if (keepFace[faces[0]] == keepFace[faces[1]]) continue;
+      const auto plane =
+        makePlane(glm::cross(corners[b] - corners[a], m_lightDirection),
+                  corners[a], centroid);
+      if (plane) volume.planes[volume.numPlanes++] = *plane;
+    }
+
+    volume.minDepth = i + 1 < m_numCascades
+                        ? cascades[i].splitDepth
+                        : std::numeric_limits<float>::lowest();
+    volume.maxDepth =
+      i > 0 ? cascades[i - 1].splitDepth : std::numeric_limits<float>::max();
+  }
+}
+
+uint8_t ShadowCasterCulling::getCascadeMask(const AABB &caster) const {
+  const auto shadowBounds = _getShadowBounds(caster).transform(m_viewMatrix);
+
+  uint8_t mask{0};
+  for (uint32_t i{0}; i < m_numCascades; ++i) {
+    const auto &volume = m_volumes[i];
+    if (shadowBounds.max.z < volume.minDepth ||
+        shadowBounds.min.z > volume.maxDepth) {
+      continue;
+    }
+    const auto planes = std::span{volume.planes}.first(volume.numPlanes);
+    if (std::ranges::none_of(planes, [&caster](const Plane &plane) {
+          return isOutside(caster, plane);
+        })) {
+      mask |= 1u << i;
+    }
+  }
+  return mask;
+}
+
+AABB ShadowCasterCulling::_getShadowBounds(const AABB &caster) const {
+  // The farthest that any point of the caster can go before it leaves the
+  // receivers (along one of the axes).
+  auto distance = std::numeric_limits<float>::max();
+  for (auto axis = 0; axis < 3; ++axis) {
+    const auto d = m_lightDirection[axis];
+    if (d > 0.0f) {
+      distance = glm::min(
+        distance, (m_receiverBounds.max[axis] - caster.min[axis]) / d);
+    } else if (d < 0.0f) {
+      distance = glm::min(
+        distance, (m_receiverBounds.min[axis] - caster.max[axis]) / d);
+    }
+  }
+  const auto offset = m_lightDirection * glm::max(distance, 0.0f);
+  return {
+    .min = glm::min(caster.min, caster.min + offset),
+    .max = glm::max(caster.max, caster.max + offset),
+  };
+}
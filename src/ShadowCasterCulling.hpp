@@ -0,0 +1,49 @@
+#pragma once
+
+#include "ShadowCascadesBuilder.hpp"
+#include "Plane.hpp"
+#include "AABB.hpp"
+#include <span>
+
+/*
+ * @brief Rejects the shadow casters (already inside of the light frustum of a
+ * cascade) that can not throw a shadow on anything that the camera sees
+ * through the cascade:
+ * - outside of the camera slice swept towards the light (its convex hull),
+ * - their shadow does not reach the depth range of the slice, e.g. it falls
+ *   entirely inside of an earlier cascade.
+ */
+class ShadowCasterCulling {
+public:
+  static constexpr uint32_t kMaxNumCascades{4};
+
+  // @param receiverBounds Of everything that can receive a shadow, a shadow
+  // does not go any further.
+  ShadowCasterCulling(const PerspectiveCamera &, std::span<const Cascade>,
+                      const glm::vec3 &lightDirection,
+                      const AABB &receiverBounds);
+
+  // @return Bit per cascade (in the order of the given span).
+  [[nodiscard]] uint8_t getCascadeMask(const AABB &caster) const;
+
+private:
+  // @return The caster swept along the light, until it leaves the receivers.
+  [[nodiscard]] AABB _getShadowBounds(const AABB &caster) const;
+
+private:
+  glm::mat4 m_viewMatrix;
+  glm::vec3 m_lightDirection;
+  AABB m_receiverBounds;
+
+  struct Volume {
+    // Kept faces of the slice + its silhouette edges, extruded.
+    static constexpr uint32_t kMaxNumPlanes{6 + 12};
+    std::array<Plane, kMaxNumPlanes> planes;
+    uint32_t numPlanes{0};
+    // View-space, selects the cascade (see _selectCascadeIndex in
+    // shaders/Resources/Cascades.glsl).
+    float minDepth, maxDepth;
+  };
+  std::array<Volume, kMaxNumCascades> m_volumes;
+  uint32_t m_numCascades{0};
+};
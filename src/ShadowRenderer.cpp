@@ -47,47 +47,35 @@ const glm::mat4 kBiasMatrix{
 #endif
 // clang-format on
 
-template <typename Func>
-requires std::is_invocable_v<Func, const AABB &>
-[[nodiscard]] auto
-getVisibleShadowCasters(std::span<const Renderable> renderables,
-                        const glm::mat4 &viewProj, Func isVisible) {
-  ZoneScoped;
-
-  std::vector<const Renderable *> result;
-  for (const auto &renderable : renderables) {
-    if ((renderable.flags & MaterialFlag_CastShadow) && isOpaque(&renderable) &&
-        isVisible(renderable.aabb)) {
-      result.push_back(&renderable);
-    }
-  }
-  return result;
-}
-
 void uploadCascades(FrameGraph &fg, FrameGraphBlackboard &blackboard,
-                    std::vector<Cascade> &&cascades) {
-  auto &shadowMatrices = blackboard.get<ShadowMapData>().viewProjMatrices;
-
-  fg.addCallbackPass(
-    "UploadCascades",
-    [&](FrameGraph::Builder &builder, auto &) {
-      shadowMatrices = builder.write(shadowMatrices);
+                    const std::vector<Cascade> &cascades) {
+  struct Data {
+    FrameGraphResource viewProjMatrices;
+  };
+  const auto &uploadedCascades = addCallbackPass<Data>(
+    fg, "UploadCascades",
+    [&](PassBuilder &builder, Data &data) {
+      data.viewProjMatrices = builder.create<FrameGraphBuffer>(
+        "CascadeMatrices", {.size = sizeof(GPUCascades), .stream = true});
+      data.viewProjMatrices = builder.write(data.viewProjMatrices);
     },
-    [=, cascades = std::move(cascades)](
-      const auto &, FrameGraphPassResources &resources, void *ctx) {
+    [=, cascades = &cascades](const Data &data,
+                              FrameGraphPassResources &resources, void *ctx) {
       NAMED_DEBUG_MARKER("UploadCascades");
       TracyGpuZone("UploadCascades");
 
       GPUCascades gpuCascades{};
-      for (uint32_t i{0}; i < cascades.size(); ++i) {
-        gpuCascades.splitDepth[i] = cascades[i].splitDepth;
+      for (uint32_t i{0}; i < cascades->size(); ++i) {
+        gpuCascades.splitDepth[i] = (*cascades)[i].splitDepth;
         gpuCascades.viewProjMatrices[i] =
-          kBiasMatrix * cascades[i].viewProjMatrix;
+          kBiasMatrix * (*cascades)[i].viewProjMatrix;
       }
       static_cast<RenderContext *>(ctx)->upload(
-        getBuffer(resources, shadowMatrices), 0, sizeof(GPUCascades),
+        getBuffer(resources, data.viewProjMatrices), 0, sizeof(GPUCascades),
         &gpuCascades);
     });
+  blackboard.get<ShadowMapData>().viewProjMatrices =
+    uploadedCascades.viewProjMatrices;
 }
 
 } // namespace
@@ -96,7 +84,8 @@ void uploadCascades(FrameGraph &fg, FrameGraphBlackboard &blackboard,
 // ShadowRenderer class:
 //
 
-ShadowRenderer::ShadowRenderer(RenderContext &rc) : BaseGeometryPass{rc} {
+ShadowRenderer::ShadowRenderer(RenderContext &rc, JobSystem &jobSystem)
+    : BaseGeometryPass{rc, jobSystem} {
   m_shadowMatrices = rc.createBuffer(sizeof(GPUCascades));
 
   const uint16_t kPixels[1 * 1]{UINT16_MAX};
@@ -126,50 +115,76 @@ ShadowRenderer::~ShadowRenderer() {
     .destroy(m_shadowMatrices);
 }
 
-void ShadowRenderer::buildCascadedShadowMaps(
-  FrameGraph &fg, FrameGraphBlackboard &blackboard,
-  const PerspectiveCamera &camera, const Light *light,
-  std::span<const Renderable> renderables) {
-  auto &shadowMapData = blackboard.add<ShadowMapData>();
-  shadowMapData.viewProjMatrices =
-    importBuffer(fg, "CascadeMatrices", &m_shadowMatrices);
+JobSystem::JobHandle
+ShadowRenderer::update(const PerspectiveCamera &camera, const Light *light,
+                       std::pmr::memory_resource *memoryResource) {
+  ZoneScoped;
 
+  // The lists are created with the allocator of the given resource (see
+  // setShadowCasters), the outer vector keeps its capacity.
+  m_shadowCasters.clear();
   if (light == nullptr) {
+    m_cascades.clear();
+    return nullptr;
+  }
+  for (auto i = 0; i < kNumCascades; ++i)
+    m_shadowCasters.emplace_back(memoryResource);
+
+  return m_jobSystem.schedule(
+    [this, &camera, lightDirection = light->direction] {
+      ZoneScopedN("BuildCascades");
+      m_cascades = buildCascades(camera, lightDirection, kNumCascades, 0.94f,
+                                 kShadowMapSize);
+    });
+}
+
+void ShadowRenderer::buildCascadedShadowMaps(FrameGraph &fg,
+                                             FrameGraphBlackboard &blackboard) {
+  auto &shadowMapData = blackboard.add<ShadowMapData>();
+
+  if (m_cascades.empty()) {
+    shadowMapData.viewProjMatrices =
+      importBuffer(fg, "CascadeMatrices", &m_shadowMatrices);
     shadowMapData.cascadedShadowMaps =
       importTexture(fg, "DummyShadowMaps", &m_dummyShadowMaps);
   } else {
-    auto cascades = buildCascades(camera, light->direction, kNumCascades, 0.94f,
-                                  kShadowMapSize);
-
     std::optional<FrameGraphResource> cascadedShadowMaps;
-    for (uint32_t i{0}; i < cascades.size(); ++i) {
-      const auto &lightViewProj = cascades[i].viewProjMatrix;
-      auto visibleShadowCasters = getVisibleShadowCasters(
-        renderables, lightViewProj,
-        [frustum = Frustum{lightViewProj}](const AABB &aabb) {
-          return frustum.testAABB(aabb);
-        });
+    for (uint32_t i{0}; i < m_cascades.size(); ++i) {
       // The first iteration will be responsible for creation of the shadowmap
       // (Texture2DArray)
-      cascadedShadowMaps =
-        _addCascadePass(fg, cascadedShadowMaps, lightViewProj,
-                        std::move(visibleShadowCasters), i);
+      cascadedShadowMaps = _addCascadePass(fg, cascadedShadowMaps, i);
     }
     assert(cascadedShadowMaps);
     shadowMapData.cascadedShadowMaps = *cascadedShadowMaps;
-    uploadCascades(fg, blackboard, std::move(cascades));
+    // Sets shadowMapData.viewProjMatrices
+    uploadCascades(fg, blackboard, m_cascades);
   }
 }
 
+std::span<const Cascade> ShadowRenderer::getCascades() const {
+  return m_cascades;
+}
+
+void ShadowRenderer::setShadowCasters(uint32_t cascadeIdx,
+                                      RenderableList &&casters) {
+  // The same allocator, so the storage is taken over (not copied).
+  auto &dst = m_shadowCasters[cascadeIdx];
+  assert(casters.get_allocator() == dst.get_allocator());
+  dst = std::move(casters);
+}
+std::span<const RenderableList> ShadowRenderer::getShadowCasters() const {
+  return m_shadowCasters;
+}
+
 FrameGraphResource ShadowRenderer::visualizeCascades(
   FrameGraph &fg, FrameGraphBlackboard &blackboard, FrameGraphResource target) {
   const auto [frameBlock] = blackboard.get<FrameData>();
   const auto depth = blackboard.get<GBufferData>().depth;
   const auto cascades = blackboard.get<ShadowMapData>().viewProjMatrices;
 
-  fg.addCallbackPass(
-    "VisualizeCascades",
-    [&](FrameGraph::Builder &builder, auto &) {
+  addCallbackPass(
+    fg, "VisualizeCascades",
+    [&](PassBuilder &builder, auto &) {
       builder.read(frameBlock);
       builder.read(depth);
       builder.read(cascades);
@@ -235,7 +250,8 @@ ShadowRenderer::_createBasePassPipeline(const VertexFormat &vertexFormat,
 
   ShaderCodeBuilder shaderCodeBuilder;
   shaderCodeBuilder.setDefines(buildDefines(vertexFormat))
-    .addDefine("DEPTH_PASS", 1);
+    .addDefine("DEPTH_PASS", 1)
+    .addDefine("MULTI_DRAW", 1);
 
   const auto vertCode =
     shaderCodeBuilder.replace("#pragma USER_CODE", material->getUserVertCode())
@@ -250,7 +266,7 @@ ShadowRenderer::_createBasePassPipeline(const VertexFormat &vertexFormat,
       .build("DepthPass.frag");
 
   const auto program =
-    m_renderContext.createGraphicsProgram(vertCode, fragCode);
+    m_renderContext.createGraphicsProgramAsync(vertCode, fragCode);
 
   return GraphicsPipeline::Builder{}
     .setDepthStencil({
@@ -271,17 +287,18 @@ ShadowRenderer::_createBasePassPipeline(const VertexFormat &vertexFormat,
 
 FrameGraphResource ShadowRenderer::_addCascadePass(
   FrameGraph &fg, std::optional<FrameGraphResource> cascadedShadowMaps,
-  const glm::mat4 &lightViewProj, std::vector<const Renderable *> &&renderables,
   uint32_t cascadeIdx) {
   assert(cascadeIdx < kNumCascades);
-  const auto name = "CSM #" + std::to_string(cascadeIdx);
+  constexpr std::array<std::string_view, kNumCascades> kPassNames{
+    "CSM #0", "CSM #1", "CSM #2", "CSM #3"};
+  const auto name = kPassNames[cascadeIdx];
 
   struct Data {
     FrameGraphResource output;
   };
-  auto &pass = fg.addCallbackPass<Data>(
-    name,
-    [&](FrameGraph::Builder &builder, Data &data) {
+  auto &pass = addCallbackPass<Data>(
+    fg, name,
+    [&](PassBuilder &builder, Data &data) {
       if (cascadeIdx == 0) {
         assert(!cascadedShadowMaps);
         cascadedShadowMaps = builder.create<FrameGraphTexture>(
@@ -294,8 +311,8 @@ FrameGraphResource ShadowRenderer::_addCascadePass(
       }
       data.output = builder.write(*cascadedShadowMaps);
     },
-    [=, this, renderables = std::move(renderables)](
-      const Data &data, FrameGraphPassResources &resources, void *ctx) {
+    [=, this](const Data &data, FrameGraphPassResources &resources,
+              void *ctx) {
       NAMED_DEBUG_MARKER(name);
       TracyGpuZone("CSM");
 
@@ -311,15 +328,8 @@ FrameGraphResource ShadowRenderer::_addCascadePass(
       };
       auto &rc = *static_cast<RenderContext *>(ctx);
       const auto framebuffer = rc.beginRendering(renderingInfo);
-      for (const auto *renderable : renderables) {
-        const auto &[mesh, subMeshIndex, material, _0, modelMatrix, _1] =
-          *renderable;
-
-        rc.setGraphicsPipeline(_getPipeline(*mesh.vertexFormat, &material));
-        _setTransform(lightViewProj, modelMatrix);
-        rc.draw(*mesh.vertexBuffer, *mesh.indexBuffer,
-                mesh.subMeshes[subMeshIndex].geometryInfo);
-      }
+      _drawRenderables(m_shadowCasters[cascadeIdx],
+                       m_cascades[cascadeIdx].viewProjMatrix, std::nullopt);
       rc.endRendering(framebuffer);
     });
 
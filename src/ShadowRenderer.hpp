@@ -3,16 +3,36 @@
 #include "fg/Fwd.hpp"
 #include "Passes/BaseGeometryPass.hpp"
 #include "Light.hpp"
+#include "ShadowCascadesBuilder.hpp"
 #include <span>
+#include <memory_resource>
 
 class ShadowRenderer final : public BaseGeometryPass {
 public:
-  explicit ShadowRenderer(RenderContext &);
+  ShadowRenderer(RenderContext &, JobSystem &);
   ~ShadowRenderer();
 
-  void buildCascadedShadowMaps(FrameGraph &, FrameGraphBlackboard &,
-                               const PerspectiveCamera &, const Light *,
-                               std::span<const Renderable>);
+  // @brief Schedules building the cascades, the passes added by
+  // buildCascadedShadowMaps read them (and the casters) when the FrameGraph
+  // executes.
+  // @param light A directional light (nullptr = no shadows).
+  // @param memoryResource Per-frame, the lists of casters are allocated from
+  // it (hence it must not be released until the next update).
+  // @return Cull the casters once it is done (null if no light).
+  [[nodiscard]] JobSystem::JobHandle update(const PerspectiveCamera &,
+                                            const Light *light,
+                                            std::pmr::memory_resource *);
+  // @brief Adds cascade passes, or imports dummy shadow maps if the last
+  // update had no light.
+  void buildCascadedShadowMaps(FrameGraph &, FrameGraphBlackboard &);
+
+  // @return Valid once the update job is done (empty = no light).
+  [[nodiscard]] std::span<const Cascade> getCascades() const;
+
+  // @param casters Allocated from the resource given to the last update.
+  void setShadowCasters(uint32_t cascadeIdx, RenderableList &&casters);
+  // @return Per cascade.
+  [[nodiscard]] std::span<const RenderableList> getShadowCasters() const;
 
   [[nodiscard]] FrameGraphResource visualizeCascades(FrameGraph &,
                                                      FrameGraphBlackboard &,
@@ -27,12 +47,14 @@ private:
   [[nodiscard]] FrameGraphResource
   _addCascadePass(FrameGraph &,
                   std::optional<FrameGraphResource> cascadedShadowMaps,
-                  const glm::mat4 &lightViewProj,
-                  std::vector<const Renderable *> &&, uint32_t cascadeIdx);
+                  uint32_t cascadeIdx);
 
 private:
   Buffer m_shadowMatrices;
   Texture m_dummyShadowMaps;
 
   GraphicsPipeline m_debugPipeline;
+
+  std::vector<Cascade> m_cascades; // Empty = no light.
+  std::vector<RenderableList> m_shadowCasters; // Per cascade.
 };
@@ -7,9 +7,9 @@
 //
 
 Texture::Texture(Texture &&other) noexcept
-    : m_id{other.m_id}, m_type{other.m_type}, m_view{other.m_view},
-      m_extent{other.m_extent}, m_depth{other.m_depth},
-      m_numMipLevels{other.m_numMipLevels}, m_numLayers{other.m_numLayers},
+    : m_id{other.m_id}, m_type{other.m_type}, m_extent{other.m_extent},
+      m_depth{other.m_depth}, m_numMipLevels{other.m_numMipLevels},
+      m_numLayers{other.m_numLayers},
       m_pixelFormat{other.m_pixelFormat} {
   memset(&other, 0, sizeof(Texture));
 }
@@ -56,6 +56,36 @@ glm::uvec3 calcMipSize(const glm::uvec3 &baseSize, uint32_t level) {
 }
 
 // clang-format off
+uint32_t getBytesPerPixel(PixelFormat pixelFormat) {
+  switch (pixelFormat) {
+    using enum PixelFormat;
+
+  case R8_UNorm: return 1;
+
+  case RGB8_UNorm:
+  case RGBA8_UNorm:
+  case RGB8_SNorm:
+  case RGBA8_SNorm: return 4;
+
+  case R16F: return 2;
+  case RG16F: return 4;
+  case RGB16F:
+  case RGBA16F: return 8;
+
+  case RGB32F:
+  case RGBA32F:
+  case RGBA32UI: return 16;
+
+  case Depth16: return 2;
+  case Depth24:
+  case Depth32F: return 4;
+
+  case Unknown: break;
+  }
+
+  return 0;
+}
+
 const char *toString(PixelFormat pixelFormat) {
   switch (pixelFormat) {
     using enum PixelFormat;
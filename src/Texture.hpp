@@ -69,8 +69,6 @@ private:
   GLuint m_id{GL_NONE};
   GLenum m_type{GL_NONE};
 
-  GLuint m_view{GL_NONE};
-
   Extent2D m_extent{0u};
   uint32_t m_depth{0u};
   uint32_t m_numMipLevels{1u};
@@ -113,4 +111,7 @@ struct SamplerInfo {
 [[nodiscard]] glm::uvec3 calcMipSize(const glm::uvec3 &baseSize,
                                      uint32_t level);
 
+// @return Estimated (3 component formats are usually padded to 4).
+[[nodiscard]] uint32_t getBytesPerPixel(PixelFormat);
+
 [[nodiscard]] const char *toString(PixelFormat);
@@ -75,9 +75,9 @@ TiledLighting::_buildFrustums(FrameGraph &fg, FrameGraphBlackboard &blackboard,
   struct FrustumsData {
     FrameGraphResource gridFrustums;
   };
-  auto &pass = fg.addCallbackPass<FrustumsData>(
-    "BuildFrustums",
-    [&](FrameGraph::Builder &builder, FrustumsData &data) {
+  auto &pass = addCallbackPass<FrustumsData>(
+    fg, "BuildFrustums",
+    [&](PassBuilder &builder, FrustumsData &data) {
       builder.read(frameBlock);
 
       const auto bufferSize =
@@ -115,9 +115,9 @@ void TiledLighting::_cullLights(FrameGraph &fg,
     FrameGraphResource lightGrid;
     std::optional<FrameGraphResource> debugMap;
   };
-  auto &pass = fg.addCallbackPass<Data>(
-    "CullLights",
-    [&](FrameGraph::Builder &builder, Data &data) {
+  auto &pass = addCallbackPass<Data>(
+    fg, "CullLights",
+    [&](PassBuilder &builder, Data &data) {
       builder.read(frameBlock);
 
       builder.read(gridFrustums);
@@ -5,6 +5,10 @@
 
 #include "tracy/Tracy.hpp"
 
+#include <algorithm>
+#include <cassert>
+#include <format>
+
 namespace std {
 
 template <> struct hash<FrameGraphTexture::Desc> {
@@ -16,33 +20,48 @@ template <> struct hash<FrameGraphTexture::Desc> {
     return h;
   }
 };
-template <> struct hash<FrameGraphBuffer::Desc> {
-  std::size_t operator()(const FrameGraphBuffer::Desc &desc) const noexcept {
-    std::size_t h{0};
-    hashCombine(h, desc.size);
-    return h;
-  }
-};
 
 } // namespace std
 
 namespace {
 
-void heartbeat(auto &objects, auto &pools, float dt, auto &&deleter) {
-  constexpr auto kMaxIdleTime = 1.0f; // in seconds
+constexpr uint64_t kMaxIdleFrames{60};
 
+void updatePeaks(TransientResources::MemoryStats &stats) {
+  stats.peak = std::max(stats.peak, stats.live + stats.pooled);
+  stats.peakLive = std::max(stats.peakLive, stats.live);
+}
+
+[[nodiscard]] std::size_t calcTextureSize(const Texture &texture) {
+  const auto extent = texture.getExtent();
+  const glm::uvec3 baseSize{extent.width, extent.height,
+                            std::max(texture.getDepth(), 1u)};
+  std::size_t numTexels{0};
+  for (uint32_t level{0}; level < texture.getNumMipLevels(); ++level) {
+    const auto mipSize = glm::max(calcMipSize(baseSize, level), 1u);
+    numTexels += std::size_t{mipSize.x} * mipSize.y * mipSize.z;
+  }
+  return numTexels * std::max(texture.getNumLayers(), 1u) *
+         getBytesPerPixel(texture.getPixelFormat());
+}
+
+void heartbeat(auto &objects, auto &pools, const RenderContext &rc,
+               auto &&isResident, auto &&deleter) {
   auto poolIt = pools.begin();
   while (poolIt != pools.end()) {
-    auto &[_, pool] = *poolIt;
+    auto &[key, pool] = *poolIt;
     if (pool.empty()) {
       poolIt = pools.erase(poolIt);
+    } else if (isResident(key)) {
+      ++poolIt;
     } else {
       auto objectIt = pool.begin();
       while (objectIt != pool.cend()) {
-        auto &[object, idleTime] = *objectIt;
-        idleTime += dt;
-        if (idleTime >= kMaxIdleTime) {
-          deleter(*object);
+        const auto &[object, releasedAt] = *objectIt;
+        // Destroy only what the GPU has finished with.
+        if (rc.getFrameIndex() - releasedAt >= kMaxIdleFrames &&
+            rc.isFrameComplete(releasedAt)) {
+          deleter(key, *object);
           SPDLOG_INFO("Released resource: {}", fmt::ptr(object));
           objectIt = pool.erase(objectIt);
         } else {
@@ -68,16 +87,31 @@ TransientResources::TransientResources(RenderContext &rc)
 TransientResources::~TransientResources() {
   for (auto &texture : m_textures)
     m_renderContext.destroy(*texture);
-  for (auto &buffer : m_buffers)
-    m_renderContext.destroy(*buffer);
+  for (auto &[view, _] : m_buffers)
+    m_renderContext.destroy(*view);
+  for (auto &[allocation, _] : m_releasedBuffers)
+    m_renderContext.destroy(*allocation.view);
+  m_bufferArenas.clear();
+  for (auto &buffer : m_streamBuffers)
+    m_renderContext.destroy(buffer);
 }
 
-void TransientResources::update(float dt) {
+void TransientResources::update() {
   ZoneScoped;
 
-  const auto deleter = [&](auto &object) { m_renderContext.destroy(object); };
-  heartbeat(m_textures, m_texturePools, dt, deleter);
-  heartbeat(m_buffers, m_bufferPools, dt, deleter);
+  heartbeat(
+    m_textures, m_texturePools, m_renderContext,
+    [this](std::size_t key) {
+      return m_renderContext.getFrameIndex() <
+             m_texturePoolInfos[key].residentUntil;
+    },
+    [this](std::size_t key, Texture &texture) { _destroy(key, texture); });
+  _freeBuffers();
+  _enforceMemoryBudget();
+
+  for (auto &buffer : m_streamBuffers)
+    m_renderContext.destroy(buffer);
+  m_streamBuffers.clear();
 }
 
 Texture *
@@ -122,39 +156,272 @@ TransientResources::acquireTexture(const FrameGraphTexture::Desc &desc) {
     if (desc.shadowSampler) samplerInfo.compareOp = CompareOp::LessOrEqual;
     m_renderContext.setupSampler(texture, samplerInfo);
 
+    if (auto &info = m_texturePoolInfos[h]; info.stats.name.empty()) {
+      info.textureSize = calcTextureSize(texture);
+      info.stats.name = FrameGraphTexture::toString(desc);
+    }
+    _updateTexturePool(h, 1, 0);
     m_textures.push_back(std::make_unique<Texture>(std::move(texture)));
     auto *ptr = m_textures.back().get();
     SPDLOG_INFO("Created texture: {}", fmt::ptr(ptr));
+    _enforceMemoryBudget();
     return ptr;
   } else {
     auto *texture = pool.back().resource;
     pool.pop_back();
+    _updateTexturePool(h, 1, -1);
     return texture;
   }
 }
+void TransientResources::setMemoryBudget(std::size_t bytes,
+                                         BudgetPolicy policy) {
+  m_memoryBudget = bytes;
+  m_budgetPolicy = policy;
+  _enforceMemoryBudget();
+}
+void TransientResources::preallocate(const Declarations &declarations) {
+  ZoneScoped;
+
+  uint32_t numPasses{0};
+  for (const auto &d : declarations.textures)
+    numPasses = std::max(numPasses, d.lastPass + 1);
+  for (const auto &d : declarations.buffers)
+    numPasses = std::max(numPasses, d.lastPass + 1);
+
+  // The same as FrameGraph::execute does: create before the first pass,
+  // release after the last one (a texture is then reused by later passes).
+  const auto residentUntil = m_renderContext.getFrameIndex() + kResidentFrames;
+  std::vector<Texture *> textures(declarations.textures.size());
+  // Stream buffers come from the upload ring (nothing to allocate).
+  std::vector<Buffer *> buffers(declarations.buffers.size());
+  for (uint32_t pass{0}; pass < numPasses; ++pass) {
+    for (std::size_t i{0}; i < textures.size(); ++i) {
+      const auto &[desc, firstPass, _] = declarations.textures[i];
+      if (firstPass != pass) continue;
+      textures[i] = acquireTexture(desc);
+      auto &info =
+        m_texturePoolInfos[std::hash<FrameGraphTexture::Desc>{}(desc)];
+      info.residentUntil = std::max(info.residentUntil, residentUntil);
+    }
+    for (std::size_t i{0}; i < buffers.size(); ++i) {
+      const auto &[desc, firstPass, _] = declarations.buffers[i];
+      if (firstPass == pass && !desc.stream) buffers[i] = acquireBuffer(desc);
+    }
+
+    for (std::size_t i{0}; i < textures.size(); ++i) {
+      const auto &[desc, _, lastPass] = declarations.textures[i];
+      if (lastPass == pass) releaseTexture(desc, textures[i]);
+    }
+    for (std::size_t i{0}; i < buffers.size(); ++i) {
+      const auto &[desc, _, lastPass] = declarations.buffers[i];
+      if (lastPass == pass && buffers[i]) releaseBuffer(desc, buffers[i]);
+    }
+  }
+}
+
+std::size_t TransientResources::getMemoryBudget() const {
+  return m_memoryBudget;
+}
+TransientResources::BudgetPolicy TransientResources::getBudgetPolicy() const {
+  return m_budgetPolicy;
+}
+
+const TransientResources::MemoryStats &
+TransientResources::getTextureMemoryStats() const {
+  return m_textureMemoryStats;
+}
+const TransientResources::MemoryStats &
+TransientResources::getBufferMemoryStats() const {
+  return m_bufferMemoryStats;
+}
+std::vector<TransientResources::PoolStats>
+TransientResources::getPoolStats() const {
+  std::vector<PoolStats> result;
+  result.reserve(m_texturePoolInfos.size() + m_bufferArenas.size());
+  for (const auto &[_, info] : m_texturePoolInfos)
+    result.push_back(info.stats);
+
+  for (const auto &[arena, lastUsedAt, peakUsedSize] : m_bufferArenas) {
+    const auto usedSize = static_cast<std::size_t>(arena->getUsedSize());
+    PoolStats stats{
+      .name = std::format("BufferArena {}",
+                          static_cast<const void *>(arena.get())),
+      .memory =
+        {
+          .live = usedSize,
+          .pooled = static_cast<std::size_t>(arena->getCapacity()) - usedSize,
+          .peak = static_cast<std::size_t>(arena->getCapacity()),
+          .peakLive = peakUsedSize,
+        },
+    };
+    for (const auto &[_, owner] : m_buffers)
+      if (owner == arena.get()) ++stats.numLive;
+    for (const auto &[allocation, _] : m_releasedBuffers)
+      if (allocation.arena == arena.get()) ++stats.numPooled;
+    result.push_back(std::move(stats));
+  }
+  std::ranges::sort(result, std::greater{},
+                    [](const auto &stats) { return stats.memory.peak; });
+  return result;
+}
+
 void TransientResources::releaseTexture(const FrameGraphTexture::Desc &desc,
                                         Texture *texture) {
   const auto h = std::hash<FrameGraphTexture::Desc>{}(desc);
-  m_texturePools[h].push_back({texture, 0.0f});
+  // Can be reused right away (even in the same frame), a texture is only
+  // written by the GPU and commands execute in order.
+  m_texturePools[h].push_back({texture, m_renderContext.getFrameIndex()});
+  _updateTexturePool(h, -1, 1);
 }
 
 Buffer *TransientResources::acquireBuffer(const FrameGraphBuffer::Desc &desc) {
-  const auto h = std::hash<FrameGraphBuffer::Desc>{}(desc);
-  auto &pool = m_bufferPools[h];
-  if (pool.empty()) {
-    auto buffer = m_renderContext.createBuffer(desc.size);
-    m_buffers.push_back(std::make_unique<Buffer>(std::move(buffer)));
-    auto *ptr = m_buffers.back().get();
-    SPDLOG_INFO("Created buffer: {}", fmt::ptr(ptr));
-    return ptr;
-  } else {
-    auto *buffer = pool.back().resource;
-    pool.pop_back();
+  if (desc.stream) {
+    return &m_streamBuffers.emplace_back(
+      m_renderContext.createStreamBuffer(desc.size));
+  }
+
+  const auto frameIndex = m_renderContext.getFrameIndex();
+  const auto allocate = [this, frameIndex](ArenaEntry &entry, Buffer view) {
+    entry.lastUsedAt = frameIndex;
+    entry.peakUsedSize =
+      std::max(entry.peakUsedSize,
+               static_cast<std::size_t>(entry.arena->getUsedSize()));
+    auto *buffer =
+      m_buffers
+        .emplace_back(std::make_unique<Buffer>(std::move(view)),
+                      entry.arena.get())
+        .view.get();
+    _updateBufferMemoryStats();
     return buffer;
+  };
+  for (auto &entry : m_bufferArenas) {
+    if (auto view = entry.arena->allocate(desc.size); view)
+      return allocate(entry, std::move(*view));
   }
+  // Oversized buffers get a dedicated arena.
+  auto &entry = m_bufferArenas.emplace_back(
+    std::make_unique<BufferArena>(m_renderContext,
+                                  std::max(desc.size, kBufferArenaSize)),
+    frameIndex);
+  SPDLOG_INFO("Created buffer arena: {} ({} bytes)",
+              fmt::ptr(entry.arena.get()), entry.arena->getCapacity());
+  return allocate(entry, std::move(*entry.arena->allocate(desc.size)));
 }
 void TransientResources::releaseBuffer(const FrameGraphBuffer::Desc &desc,
                                        Buffer *buffer) {
-  const auto h = std::hash<FrameGraphBuffer::Desc>{}(desc);
-  m_bufferPools[h].push_back({std::move(buffer), 0.0f});
+  if (desc.stream) return; // Recycled in update.
+
+  const auto it = std::ranges::find_if(
+    m_buffers, [buffer](const auto &e) { return e.view.get() == buffer; });
+  assert(it != m_buffers.cend());
+  // A buffer might be updated by the CPU, handing the range out again while
+  // the GPU might still read it would make the driver stall.
+  m_releasedBuffers.push_back(
+    {std::move(*it), m_renderContext.getFrameIndex()});
+  m_buffers.erase(it);
+}
+
+void TransientResources::_freeBuffers() {
+  while (!m_releasedBuffers.empty()) {
+    auto &[allocation, releasedAt] = m_releasedBuffers.front();
+    if (!m_renderContext.isFrameComplete(releasedAt)) break;
+
+    allocation.arena->free(*allocation.view);
+    m_releasedBuffers.pop_front();
+  }
+
+  const auto frameIndex = m_renderContext.getFrameIndex();
+  std::erase_if(m_bufferArenas, [frameIndex](const auto &entry) {
+    const auto &[arena, lastUsedAt, _] = entry;
+    if (arena->isEmpty() && frameIndex - lastUsedAt >= kMaxIdleFrames) {
+      SPDLOG_INFO("Released buffer arena: {}", fmt::ptr(arena.get()));
+      return true;
+    }
+    return false;
+  });
+  _updateBufferMemoryStats();
+}
+
+void TransientResources::_updateTexturePool(std::size_t key, int32_t numLive,
+                                            int32_t numPooled) {
+  auto &[textureSize, _, stats] = m_texturePoolInfos[key];
+  stats.numLive += numLive;
+  stats.numPooled += numPooled;
+
+  const auto update = [textureSize](MemoryStats &memory, int32_t numLive,
+                                    int32_t numPooled) {
+    memory.live += numLive * static_cast<std::ptrdiff_t>(textureSize);
+    memory.pooled += numPooled * static_cast<std::ptrdiff_t>(textureSize);
+    updatePeaks(memory);
+  };
+  update(stats.memory, numLive, numPooled);
+  update(m_textureMemoryStats, numLive, numPooled);
+}
+void TransientResources::_updateBufferMemoryStats() {
+  std::size_t capacity{0};
+  std::size_t usedSize{0};
+  for (const auto &entry : m_bufferArenas) {
+    capacity += entry.arena->getCapacity();
+    usedSize += entry.arena->getUsedSize();
+  }
+  // A range is busy until the GPU is done with it, hence live.
+  m_bufferMemoryStats.live = usedSize;
+  m_bufferMemoryStats.pooled = capacity - usedSize;
+  updatePeaks(m_bufferMemoryStats);
+}
+
+void TransientResources::_destroy(std::size_t poolKey, Texture &texture) {
+  _updateTexturePool(poolKey, 0, -1);
+  m_renderContext.destroy(texture);
+}
+
+bool TransientResources::_evictOldestTexture() {
+  ResourcePool<Texture *> *oldestPool{nullptr};
+  ResourcePool<Texture *>::iterator oldest;
+  std::size_t oldestKey{0};
+  for (auto &[key, pool] : m_texturePools) {
+    // The front of a pool is the oldest entry.
+    if (pool.empty()) continue;
+    const auto releasedAt = pool.front().frameIndex;
+    if (!m_renderContext.isFrameComplete(releasedAt)) continue;
+
+    if (!oldestPool || releasedAt < oldest->frameIndex) {
+      oldestPool = &pool;
+      oldest = pool.begin();
+      oldestKey = key;
+    }
+  }
+  if (!oldestPool) return false;
+
+  _destroy(oldestKey, *oldest->resource);
+  SPDLOG_INFO("Evicted texture: {}", fmt::ptr(oldest->resource));
+  oldestPool->erase(oldest);
+  return true;
+}
+void TransientResources::_enforceMemoryBudget() {
+  const auto getTotalMemory = [this] {
+    return m_textureMemoryStats.live + m_textureMemoryStats.pooled +
+           m_bufferMemoryStats.live + m_bufferMemoryStats.pooled;
+  };
+  if (m_budgetPolicy == BudgetPolicy::Evict) {
+    auto evicted = false;
+    while (getTotalMemory() > m_memoryBudget && _evictOldestTexture())
+      evicted = true;
+    if (evicted) {
+      std::erase_if(m_textures,
+                    [](const auto &texture) { return !(*texture); });
+    }
+  }
+
+  // Whatever is left is in use (or the GPU is not done with it yet).
+  const auto totalMemory = getTotalMemory();
+  const auto overBudget = totalMemory > m_memoryBudget;
+  if (overBudget && !m_overBudget) {
+    SPDLOG_WARN("Transient resources over budget: {} / {} bytes "
+                "(textures: {} live, {} pooled; buffers: {} live, {} pooled)",
+                totalMemory, m_memoryBudget, m_textureMemoryStats.live,
+                m_textureMemoryStats.pooled, m_bufferMemoryStats.live,
+                m_bufferMemoryStats.pooled);
+  }
+  m_overBudget = overBudget;
 }
@@ -2,9 +2,13 @@
 
 #include "FrameGraphTexture.hpp"
 #include "FrameGraphBuffer.hpp"
+#include "BufferArena.hpp"
 #include <memory>
+#include <string>
 #include <vector>
+#include <deque>
 #include <unordered_map>
+#include <limits>
 
 class RenderContext;
 
@@ -19,7 +23,56 @@ public:
   TransientResources &operator=(const TransientResources &) = delete;
   TransientResources &operator=(TransientResources &&) noexcept = delete;
 
-  void update(float dt);
+  // @brief Evicts resources that have been idle for too many frames.
+  // @remark Call once per frame, before RenderContext::endFrame.
+  void update();
+
+  // Resources that FrameGraph passes declare, in the order of the passes (see
+  // TransientDeclarationScope in FrameGraphHelper.hpp).
+  template <typename Desc> struct Declaration {
+    Desc desc;
+    uint32_t firstPass; // Creates the resource.
+    uint32_t lastPass;  // The last one that reads or writes it.
+  };
+  struct Declarations {
+    std::vector<Declaration<FrameGraphTexture::Desc>> textures;
+    std::vector<Declaration<FrameGraphBuffer::Desc>> buffers;
+  };
+  // @brief Creates the declared resources and pools them right away (nothing
+  // is executed). Replays the lifetimes along the pass order, hence only as
+  // many resources as the FrameGraph uses at a time are created. The texture
+  // pools stay resident, exempt from the idle eviction, for kResidentFrames
+  // (the budget still applies).
+  void preallocate(const Declarations &);
+  static constexpr uint64_t kResidentFrames{600};
+
+  enum class BudgetPolicy {
+    Log,  // Only warn when over budget.
+    Evict // Idle (pooled) textures are evicted until back within budget.
+  };
+  // @brief The budget covers all the transient textures and buffer arenas
+  // (in use or not).
+  void setMemoryBudget(std::size_t bytes, BudgetPolicy = BudgetPolicy::Evict);
+  [[nodiscard]] std::size_t getMemoryBudget() const;
+  [[nodiscard]] BudgetPolicy getBudgetPolicy() const;
+
+  struct MemoryStats {
+    std::size_t live{0};   // In use by the current frame (in bytes).
+    std::size_t pooled{0}; // Idle, waiting for reuse or eviction.
+    std::size_t peak{0};   // Max of live + pooled.
+    std::size_t peakLive{0};
+  };
+  struct PoolStats {
+    std::string name;
+    uint32_t numLive{0};
+    uint32_t numPooled{0};
+    MemoryStats memory;
+  };
+  [[nodiscard]] const MemoryStats &getTextureMemoryStats() const;
+  [[nodiscard]] const MemoryStats &getBufferMemoryStats() const;
+  // @return Texture pools (also those already evicted, to keep the peaks)
+  // and buffer arenas, the largest peak first.
+  [[nodiscard]] std::vector<PoolStats> getPoolStats() const;
 
   [[nodiscard]] Texture *acquireTexture(const FrameGraphTexture::Desc &);
   void releaseTexture(const FrameGraphTexture::Desc &, Texture *);
@@ -27,18 +80,62 @@ public:
   [[nodiscard]] Buffer *acquireBuffer(const FrameGraphBuffer::Desc &);
   void releaseBuffer(const FrameGraphBuffer::Desc &, Buffer *);
 
+private:
+  // Returns ranges of released buffers (that the GPU is done with) to their
+  // arenas and destroys arenas that have been empty for too long.
+  void _freeBuffers();
+
+  void _updateTexturePool(std::size_t key, int32_t numLive, int32_t numPooled);
+  void _updateBufferMemoryStats();
+
+  void _destroy(std::size_t poolKey, Texture &);
+  // @return false if there is nothing more to evict.
+  bool _evictOldestTexture();
+  void _enforceMemoryBudget();
+
 private:
   RenderContext &m_renderContext;
 
   std::vector<std::unique_ptr<Texture>> m_textures;
-  std::vector<std::unique_ptr<Buffer>> m_buffers;
+  // Views into the upload ring, dropped at the end of a frame.
+  std::deque<Buffer> m_streamBuffers;
 
   template <typename T> struct ResourceEntry {
     T resource;
-    float life;
+    uint64_t frameIndex; // When released (see RenderContext::getFrameIndex).
   };
   template <typename T> using ResourcePool = std::vector<ResourceEntry<T>>;
 
   std::unordered_map<std::size_t, ResourcePool<Texture *>> m_texturePools;
-  std::unordered_map<std::size_t, ResourcePool<Buffer *>> m_bufferPools;
+
+  // Non-stream buffers are views suballocated from a few large arenas.
+  static constexpr GLsizeiptr kBufferArenaSize{16 << 20}; // 16 MiB
+  struct ArenaEntry {
+    std::unique_ptr<BufferArena> arena;
+    uint64_t lastUsedAt; // Frame index.
+    std::size_t peakUsedSize{0};
+  };
+  std::vector<ArenaEntry> m_bufferArenas;
+  struct BufferAllocation {
+    std::unique_ptr<Buffer> view;
+    BufferArena *arena;
+  };
+  std::vector<BufferAllocation> m_buffers; // In use.
+  // Returned to an arena once the GPU is done with the frame of release.
+  std::deque<ResourceEntry<BufferAllocation>> m_releasedBuffers;
+
+  struct TexturePoolInfo {
+    std::size_t textureSize{0}; // In bytes.
+    uint64_t residentUntil{0}; // Frame index.
+    PoolStats stats;
+  };
+  // Key = the same as in m_texturePools.
+  std::unordered_map<std::size_t, TexturePoolInfo> m_texturePoolInfos;
+
+  MemoryStats m_textureMemoryStats;
+  MemoryStats m_bufferMemoryStats;
+
+  std::size_t m_memoryBudget{std::numeric_limits<std::size_t>::max()};
+  BudgetPolicy m_budgetPolicy{BudgetPolicy::Evict};
+  bool m_overBudget{false};
 };
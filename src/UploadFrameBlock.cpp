@@ -42,24 +42,25 @@ struct GPUFrameBlock {
 
 void uploadFrameBlock(FrameGraph &fg, FrameGraphBlackboard &blackboard,
                       const FrameInfo &frameInfo) {
-  blackboard.add<FrameData>() = fg.addCallbackPass<FrameData>(
-    "UploadFrameBlock",
-    [&](FrameGraph::Builder &builder, FrameData &data) {
+  blackboard.add<FrameData>() = addCallbackPass<FrameData>(
+    fg, "UploadFrameBlock",
+    [&](PassBuilder &builder, FrameData &data) {
       data.frameBlock = builder.create<FrameGraphBuffer>(
-        "FrameBlock", {.size = sizeof(GPUFrameBlock)});
+        "FrameBlock", {.size = sizeof(GPUFrameBlock), .stream = true});
       data.frameBlock = builder.write(data.frameBlock);
     },
-    [=](const FrameData &data, FrameGraphPassResources &resources, void *ctx) {
+    [frameInfo = &frameInfo](const FrameData &data,
+                             FrameGraphPassResources &resources, void *ctx) {
       NAMED_DEBUG_MARKER("UploadFrameBlock");
       TracyGpuZone("UploadFrameBlock");
 
       const GPUFrameBlock frameBlock{
-        .time = frameInfo.time,
-        .deltaTime = frameInfo.deltaTime,
-        .resolution = frameInfo.resolution,
-        .camera = GPUCamera{frameInfo.camera},
-        .renderFeatures = frameInfo.features,
-        .debugFlags = frameInfo.debugFlags,
+        .time = frameInfo->time,
+        .deltaTime = frameInfo->deltaTime,
+        .resolution = frameInfo->resolution,
+        .camera = GPUCamera{*frameInfo->camera},
+        .renderFeatures = frameInfo->features,
+        .debugFlags = frameInfo->debugFlags,
       };
       static_cast<RenderContext *>(ctx)->upload(
         getBuffer(resources, data.frameBlock), 0, sizeof(GPUFrameBlock),
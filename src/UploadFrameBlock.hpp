@@ -8,8 +8,10 @@ struct FrameInfo {
   float time;
   float deltaTime;
   Extent2D resolution;
-  const PerspectiveCamera &camera;
+  const PerspectiveCamera *camera;
   uint32_t features;
   uint32_t debugFlags;
 };
-void uploadFrameBlock(FrameGraph &, FrameGraphBlackboard &, const FrameInfo &);
+// @param frameInfo Read when the pass executes (must outlive the graph).
+void uploadFrameBlock(FrameGraph &, FrameGraphBlackboard &,
+                      const FrameInfo &frameInfo);
@@ -15,6 +15,8 @@
 #include "glm/vec4.hpp"
 #include "glm/common.hpp"
 
+#include <ranges>
+
 namespace {
 
 // see _LightBuffer in shaders/Lib/Light.glsl
@@ -50,27 +52,30 @@ private:
 } // namespace
 
 void uploadLights(FrameGraph &fg, FrameGraphBlackboard &blackboard,
-                  std::vector<const Light *> &&lights) {
-  const auto numLights = uint32_t(lights.size());
-
-  blackboard.add<LightsData>() = fg.addCallbackPass<LightsData>(
-    "UploadLights",
-    [numLights](FrameGraph::Builder &builder, LightsData &data) {
+                  const std::pmr::vector<const Light *> &lights,
+                  uint32_t maxNumLights) {
+  blackboard.add<LightsData>() = addCallbackPass<LightsData>(
+    fg, "UploadLights",
+    [maxNumLights](PassBuilder &builder, LightsData &data) {
       const GLsizeiptr bufferSize =
-        kLightDataOffset + (sizeof(GPULight) * numLights);
-      data.buffer =
-        builder.create<FrameGraphBuffer>("LightsBuffer", {.size = bufferSize});
+        kLightDataOffset + (sizeof(GPULight) * maxNumLights);
+      data.buffer = builder.create<FrameGraphBuffer>(
+        "LightsBuffer", {.size = bufferSize, .stream = true});
       data.buffer = builder.write(data.buffer);
     },
-    [=](const LightsData &data, FrameGraphPassResources &resources, void *ctx) {
+    [maxNumLights, lights = &lights](const LightsData &data,
+                                     FrameGraphPassResources &resources,
+                                     void *ctx) {
       NAMED_DEBUG_MARKER("UploadLights");
       TracyGpuZone("UploadLights");
 
       auto &rc = *static_cast<RenderContext *>(ctx);
 
+      const auto numLights =
+        std::min(static_cast<uint32_t>(lights->size()), maxNumLights);
       std::vector<GPULight> gpuLights;
-      gpuLights.reserve(lights.size());
-      for (const auto *light : lights)
+      gpuLights.reserve(numLights);
+      for (const auto *light : *lights | std::views::take(numLights))
         gpuLights.emplace_back(GPULight{*light});
 
       auto &buffer = getBuffer(resources, data.buffer);
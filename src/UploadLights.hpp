@@ -3,6 +3,10 @@
 #include "fg/Fwd.hpp"
 #include "Light.hpp"
 #include <vector>
+#include <memory_resource>
 
+// @param lights Read when the pass executes (must outlive the graph).
+// @param maxNumLights Capacity of the buffer, lights above are dropped.
 void uploadLights(FrameGraph &, FrameGraphBlackboard &,
-                  std::vector<const Light *> &&);
+                  const std::pmr::vector<const Light *> &lights,
+                  uint32_t maxNumLights);
@@ -22,34 +22,62 @@
 #include "ShaderCodeBuilder.hpp"
 
 #include "LightUtility.hpp"
+#include "ShadowCasterCulling.hpp"
 #include "glm/gtc/type_ptr.hpp"
 
 #include "tracy/Tracy.hpp"
 #include "tracy/TracyOpenGL.hpp"
+#include "spdlog/spdlog.h"
 
+#include <algorithm>
 #include <ranges>
+#include <bit>
 #include <fstream>
+#include <chrono>
 
 namespace {
 
 constexpr auto kTileSize = 16u;
 
-[[nodiscard]] bool isLightInFrustum(const Light &light,
-                                    const Frustum &frustum) {
-  switch (light.type) {
-  case LightType::Point:
-    return frustum.testSphere(toSphere(light));
-  case LightType::Spot:
-    return frustum.testCone(toCone(light));
-  }
-  return true; // Directional light, always visible
-}
 [[nodiscard]] auto getVisibleLights(std::span<const Light> lights,
-                                    const Frustum &frustum) {
-  std::vector<const Light *> visibleLights;
+                                    const Frustum &frustum,
+                                    std::pmr::memory_resource *memoryResource) {
+  ZoneScoped;
+
+  // Point and spot lights are tested in batches (as spheres and cones).
+  SphereArray spheres{memoryResource};
+  std::pmr::vector<uint32_t> sphereLights{memoryResource};
+  ConeArray cones{memoryResource};
+  std::pmr::vector<uint32_t> coneLights{memoryResource};
+  std::pmr::vector<uint8_t> visible(lights.size(), memoryResource);
+  for (uint32_t i{0}; i < lights.size(); ++i) {
+    switch (const auto &light = lights[i]; light.type) {
+    case LightType::Point:
+      spheres.push_back(toSphere(light));
+      sphereLights.push_back(i);
+      break;
+    case LightType::Spot:
+      cones.push_back(toCone(light));
+      coneLights.push_back(i);
+      break;
+    default:
+      visible[i] = 1; // Directional light, always visible
+    }
+  }
+
+  std::pmr::vector<uint32_t> indices(std::max(spheres.size(), cones.size()),
+                                     memoryResource);
+  const auto numVisibleSpheres = cullSpheres(frustum, spheres, indices.data());
+  for (std::size_t i{0}; i < numVisibleSpheres; ++i)
+    visible[sphereLights[indices[i]]] = 1;
+  const auto numVisibleCones = cullCones(frustum, cones, indices.data());
+  for (std::size_t i{0}; i < numVisibleCones; ++i)
+    visible[coneLights[indices[i]]] = 1;
+
+  std::pmr::vector<const Light *> visibleLights{memoryResource};
   visibleLights.reserve(lights.size());
-  for (const auto &light : lights)
-    if (isLightInFrustum(light, frustum)) visibleLights.push_back(&light);
+  for (std::size_t i{0}; i < lights.size(); ++i)
+    if (visible[i]) visibleLights.push_back(&lights[i]);
   return visibleLights;
 }
 
@@ -64,19 +92,74 @@ getFirstDirectionalLight(std::span<const Light *> lights) {
 
 [[nodiscard]] auto
 getVisibleRenderables(std::span<const Renderable> renderables,
-                      const PerspectiveCamera &camera) {
-  std::vector<const Renderable *> result;
-  for (const auto &renderable : renderables)
-    if (camera.getFrustum().testAABB(renderable.aabb))
-      result.push_back(&renderable);
+                      const AABBArray &bounds, const BVH *bvh,
+                      const PerspectiveCamera &camera,
+                      std::pmr::memory_resource *memoryResource) {
+  ZoneScoped;
+
+  // In the order of the renderables (the batching depends on it).
+  const auto indices =
+    cullIndices(camera.getFrustum(), bounds, bvh, memoryResource);
+  RenderableList result{memoryResource};
+  result.reserve(indices.size());
+  for (const auto i : indices)
+    result.push_back(&renderables[i]);
+  return result;
+}
 
+// @brief A single pass over the renderables for all of the light views.
+// @param views The cascades first (they take only the opaque shadow casters
+// that pass the casterCulling), then the rest (they take every renderable,
+// e.g. the RSM).
+// @return A list per view, in the order of the renderables.
+[[nodiscard]] std::pmr::vector<RenderableList>
+getVisibleShadowCasters(std::span<const Renderable> renderables,
+                        const AABBArray &bounds, const BVH *bvh,
+                        std::span<const Frustum> views, uint32_t numCascades,
+                        const ShadowCasterCulling &casterCulling,
+                        std::pmr::memory_resource *memoryResource) {
+  ZoneScoped;
+
+  std::pmr::vector<RenderableList> result(views.size(), memoryResource);
+  const auto cascadeBits = static_cast<uint8_t>((1u << numCascades) - 1u);
+  const auto masks = cullMasks(views, bounds, bvh, memoryResource);
+  for (std::size_t i{0}; i < masks.size(); ++i) {
+    auto mask = masks[i];
+    if (mask == 0) continue;
+
+    const auto &renderable = renderables[i];
+    if (!(renderable.flags & MaterialFlag_CastShadow) ||
+        !isOpaque(&renderable)) {
+      mask &= ~cascadeBits;
+    } else if (mask & cascadeBits) {
+      mask &= casterCulling.getCascadeMask(renderable.aabb) | ~cascadeBits;
+    }
+    for (; mask != 0; mask &= mask - 1)
+      result[std::countr_zero(mask)].push_back(&renderable);
+  }
   return result;
 }
 
-[[nodiscard]] std::vector<const Renderable *>
-filterRenderables(std::span<const Renderable *> src, auto &&predicate) {
+void gatherBounds(std::span<const Renderable> renderables, AABBArray &out) {
+  out.clear();
+  out.reserve(renderables.size());
+  for (const auto &renderable : renderables)
+    out.push_back(renderable.aabb);
+}
+[[nodiscard]] uint32_t
+countShadowCasters(std::span<const Renderable> renderables) {
+  return static_cast<uint32_t>(
+    std::ranges::count_if(renderables, [](const Renderable &renderable) {
+      return (renderable.flags & MaterialFlag_CastShadow) &&
+             isOpaque(&renderable);
+    }));
+}
+
+[[nodiscard]] RenderableList
+filterRenderables(std::span<const Renderable *> src, auto &&predicate,
+                  std::pmr::memory_resource *memoryResource) {
   auto out = src | std::views::filter(predicate);
-  return {out.begin(), out.end()};
+  return {out.begin(), out.end(), memoryResource};
 }
 
 void importLightProbe(FrameGraph &fg, FrameGraphBlackboard &blackboard,
@@ -94,10 +177,9 @@ struct SortByDistance {
       : m_origin{camera.getPosition()}, m_order{order} {}
 
   bool operator()(const Renderable *a, const Renderable *b) const noexcept {
-    const auto distanceA =
-      glm::distance(m_origin, glm::vec3{a->modelMatrix[3]});
-    const auto distanceB =
-      glm::distance(m_origin, glm::vec3{b->modelMatrix[3]});
+    // Submeshes share the model matrix, hence the bounds.
+    const auto distanceA = glm::distance(m_origin, a->aabb.getCenter());
+    const auto distanceB = glm::distance(m_origin, b->aabb.getCenter());
 
     return m_order == SortOrder::FrontToBack ? distanceB > distanceA
                                              : distanceA > distanceB;
@@ -108,22 +190,33 @@ private:
   const SortOrder m_order;
 };
 
+// While the window is being resized, the frame is rendered at a size class
+// (rounded up to a multiple of kSizeClass), so the transient textures are not
+// recreated every frame. The FinalPass scales it to the swapchain.
+constexpr uint32_t kSizeClass{128};
+// Number of frames without a resize, after which the exact resolution is used.
+constexpr uint32_t kNumSettleFrames{30};
+
+constexpr std::size_t kTransientMemoryBudget{1024 * 1024 * 1024}; // 1 GiB
+
 } // namespace
 
 //
 // WorldRenderer class:
 //
 
-WorldRenderer::WorldRenderer(RenderContext &rc)
-    : m_renderContext{rc}, m_ibl{rc}, m_transientResources{rc},
-      m_tiledLighting{rc, kTileSize}, m_shadowRenderer{rc},
-      m_globalIllumination{rc}, m_gBufferPass{rc},
-      m_deferredLightingPass{rc, kTileSize}, m_skyboxPass{rc},
-      m_weightedBlendedPass{rc, kTileSize}, m_transparencyCompositionPass{rc},
-      m_wireframePass{rc}, m_bloom{rc}, m_ssao{rc}, m_ssr{rc},
+WorldRenderer::WorldRenderer(RenderContext &rc, JobSystem &jobSystem)
+    : m_renderContext{rc}, m_jobSystem{jobSystem}, m_ibl{rc},
+      m_transientResources{rc}, m_tiledLighting{rc, kTileSize},
+      m_shadowRenderer{rc, jobSystem}, m_globalIllumination{rc, jobSystem},
+      m_gBufferPass{rc, jobSystem}, m_deferredLightingPass{rc, kTileSize},
+      m_skyboxPass{rc}, m_weightedBlendedPass{rc, jobSystem, kTileSize},
+      m_transparencyCompositionPass{rc}, m_wireframePass{rc, jobSystem},
+      m_bloom{rc}, m_ssao{rc}, m_ssr{rc},
       m_tonemapPass{rc}, m_fxaa{rc}, m_vignettePass{rc}, m_blur{rc}, m_blit{rc},
       m_finalPass{rc} {
   m_brdf = m_ibl.generateBRDF();
+  m_transientResources.setMemoryBudget(kTransientMemoryBudget);
 }
 WorldRenderer::~WorldRenderer() {
   m_renderContext.destroy(m_brdf)
@@ -141,6 +234,90 @@ void WorldRenderer::setSkybox(Texture &cubemap) {
   m_globalLightProbe.specular = m_ibl.prefilterEnvMap(*m_skybox);
 }
 
+TransientResources &WorldRenderer::getTransientResources() {
+  return m_transientResources;
+}
+
+void WorldRenderer::setRetainFrameGraph(bool enabled) {
+  m_retainFrameGraph = enabled;
+  if (!enabled) m_frameGraph.reset();
+}
+const FrameGraphStats &WorldRenderer::getFrameGraphStats() const {
+  return m_frameGraphStats;
+}
+const FrameArenaStats &WorldRenderer::getFrameArenaStats() const {
+  return m_frameArenaStats;
+}
+const CullingStats &WorldRenderer::getCullingStats() const {
+  return m_cullingStats;
+}
+
+void WorldRenderer::buildCullingData(
+  std::span<const Renderable> renderables) {
+  const auto beginTicks = std::chrono::steady_clock::now();
+
+  std::vector<AABB> aabbs;
+  aabbs.reserve(renderables.size());
+  for (const auto &renderable : renderables)
+    aabbs.push_back(renderable.aabb);
+  m_bvh.build(aabbs);
+  gatherBounds(renderables, m_renderableBounds);
+  m_receiverBounds = m_renderableBounds.getBounds();
+  m_numShadowCasters = countShadowCasters(renderables);
+  m_cullingRenderables = renderables;
+
+  const std::chrono::duration<float, std::milli> buildTime{
+    std::chrono::steady_clock::now() - beginTicks};
+  SPDLOG_INFO("BVH: {} renderables, {} nodes, {:.2f} ms ({} culling)",
+              m_bvh.getNumPrimitives(), m_bvh.getNumNodes(),
+              buildTime.count(), toString(getSIMDLevel()));
+}
+void WorldRenderer::refitCullingData() {
+  std::vector<AABB> aabbs;
+  aabbs.reserve(m_cullingRenderables.size());
+  for (const auto &renderable : m_cullingRenderables)
+    aabbs.push_back(renderable.aabb);
+  m_bvh.refit(aabbs);
+  gatherBounds(m_cullingRenderables, m_renderableBounds);
+  m_receiverBounds = m_renderableBounds.getBounds();
+}
+
+void WorldRenderer::warmUp(const RenderSettings &settings,
+                           Extent2D resolution, const AABB &sceneAABB,
+                           const PerspectiveCamera &camera,
+                           std::span<const Light> lights,
+                           std::span<const Renderable> renderables) {
+  if (resolution.width == 0 || resolution.height == 0) return;
+  ZoneScoped;
+
+  _updateFrameParams(settings, resolution, camera, lights, renderables, 0.0f);
+  _preallocate(settings, resolution, sceneAABB);
+
+  // The pipelines of the geometry passes are created as they draw, hence the
+  // graph is executed once (the resources are already in the pools).
+  FrameGraph fg;
+  FrameGraphBlackboard blackboard;
+  _buildFrameGraph(fg, blackboard, settings, resolution, sceneAABB);
+  fg.compile();
+  {
+    NAMED_DEBUG_MARKER("WarmUp");
+    fg.execute(&m_renderContext, &m_transientResources);
+  }
+  m_transientResources.update();
+}
+void WorldRenderer::queueWarmUp(const RenderSettings &settings,
+                                Extent2D resolution) {
+  // Each feature toggled on its own, then everything at once.
+  for (auto feature = 1u; feature <= RenderFeature_Vignette; feature <<= 1) {
+    auto variant = settings;
+    variant.renderFeatures ^= feature;
+    m_warmUpQueue.push_back({variant, resolution});
+  }
+  auto variant = settings;
+  variant.renderFeatures = RenderFeature_All;
+  m_warmUpQueue.push_back({variant, resolution});
+}
+
 void WorldRenderer::drawFrame(const RenderSettings &settings,
                               Extent2D resolution, const AABB &sceneAABB,
                               const PerspectiveCamera &camera,
@@ -148,55 +325,257 @@ void WorldRenderer::drawFrame(const RenderSettings &settings,
                               std::span<const Renderable> renderables,
                               float deltaTime) {
   if (resolution.width == 0 || resolution.height == 0) return;
+  resolution = _selectRenderResolution(resolution);
 
-  FrameGraph fg;
-  FrameGraphBlackboard blackboard;
+  _updateFrameParams(settings, resolution, camera, lights, renderables,
+                     deltaTime);
+
+  // Spread over frames, one variant at a time (nothing is executed).
+  if (!m_warmUpQueue.empty()) {
+    const auto [variant, variantResolution] = m_warmUpQueue.front();
+    m_warmUpQueue.pop_front();
+    _preallocate(variant, variantResolution, sceneAABB);
+  }
+
+  // The hash rejects quickly, a match is confirmed by comparing the inputs.
+  const auto key = _makeFrameGraphKey(settings, resolution, sceneAABB);
+  const auto keyHash = _hashFrameGraphKey(key);
+  if (!m_retainFrameGraph || !m_frameGraph ||
+      keyHash != m_frameGraphKeyHash || key != m_frameGraphKey) {
+    _rebuildFrameGraph(settings, resolution, sceneAABB);
+    m_frameGraphKey = key;
+    m_frameGraphKeyHash = keyHash;
+  } else {
+    ++m_frameGraphStats.numReuses;
+  }
+  auto &fg = *m_frameGraph;
+
+#if _DEBUG
+  constexpr auto kInterval = 5.0f;
+  static float stopwatch{kInterval};
+  if (stopwatch >= kInterval) {
+    std::ofstream{"fg.dot"} << fg;
+    stopwatch = 0.0f;
+  }
+  stopwatch += deltaTime;
+#endif
+
+  {
+    TracyGpuZone("ExecuteFrameGraph");
+    fg.execute(&m_renderContext, &m_transientResources);
+  }
+
+  m_time += deltaTime;
+  m_transientResources.update();
+}
+
+void WorldRenderer::_updateFrameParams(const RenderSettings &settings,
+                                       Extent2D resolution,
+                                       const PerspectiveCamera &camera,
+                                       std::span<const Light> lights,
+                                       std::span<const Renderable> renderables,
+                                       float deltaTime) {
+  ZoneScoped;
+
+  // Everything allocated from the arena belongs to the previous frame (which
+  // has been executed by now). The containers in m_frameParams (and in the
+  // ShadowRenderer) are reassigned below, their old storage is never touched.
+  m_frameArenaStats = {
+    .numAllocations = m_frameAllocator.getStats().numAllocations,
+    .numHeapAllocations = m_frameArenaUpstream.getStats().numAllocations,
+    .numBytes = m_frameAllocator.getStats().numBytes,
+  };
+  m_frameAllocator.resetStats();
+  m_frameArenaUpstream.resetStats();
+  m_frameArena.release();
+  auto *memoryResource = &m_frameAllocator;
+
+  auto &params = m_frameParams;
+  params.frameInfo = {
+    .time = m_time,
+    .deltaTime = deltaTime,
+    .resolution = resolution,
+    .camera = &camera,
+    .features = settings.renderFeatures,
+    .debugFlags = settings.debugFlags,
+  };
+  params.maxNumLights = static_cast<uint32_t>(lights.size());
+  params.visibleLights =
+    getVisibleLights(lights, camera.getFrustum(), memoryResource);
+  params.directionalLight = getFirstDirectionalLight(params.visibleLights);
+
+  // The shadow (and GI) jobs run alongside the camera culling.
+  const bool hasShadows = settings.renderFeatures & RenderFeature_Shadows;
+  const auto hasCullingData =
+    renderables.data() == m_cullingRenderables.data() &&
+    renderables.size() == m_cullingRenderables.size();
+  AABBArray frameBounds{memoryResource};
+  if (!hasCullingData) gatherBounds(renderables, frameBounds);
+  const auto &bounds = hasCullingData ? m_renderableBounds : frameBounds;
+  const auto *bvh = hasCullingData && settings.culling == CullingMethod::BVH
+                      ? &m_bvh
+                      : nullptr;
+
+  const auto cascades = m_shadowRenderer.update(
+    camera, hasShadows ? params.directionalLight : nullptr, memoryResource);
+  const bool hasGI = (settings.renderFeatures & RenderFeature_GI) &&
+                     params.directionalLight;
+  if (hasGI) {
+    m_globalIllumination.update(camera, *params.directionalLight,
+                                memoryResource);
+  }
+
+  // The cascades and the reflective shadow map share a single pass.
+  JobSystem::JobHandle shadowCasters;
+  if (cascades || hasGI) {
+    shadowCasters = m_jobSystem.schedule(
+      [this, &camera, light = params.directionalLight, hasGI, renderables,
+       &bounds, hasCullingData, bvh, memoryResource] {
+        ZoneScopedN("CullShadowCasters");
+        const auto cascadeList = m_shadowRenderer.getCascades();
+        std::pmr::vector<Frustum> views{memoryResource};
+        for (const auto &cascade : cascadeList)
+          views.emplace_back(cascade.viewProjMatrix);
+        const auto numCascades = static_cast<uint32_t>(views.size());
+        if (hasGI)
+          views.emplace_back(m_globalIllumination.getLightViewProjection());
+
+        // Everything is a receiver (the ReceiveShadow flag is not checked).
+        const ShadowCasterCulling casterCulling{
+          camera,
+          cascadeList,
+          light->direction,
+          hasCullingData ? m_receiverBounds : bounds.getBounds(),
+        };
+        auto lists =
+          getVisibleShadowCasters(renderables, bounds, bvh, views, numCascades,
+                                  casterCulling, memoryResource);
+        for (uint32_t i{0}; i < numCascades; ++i)
+          m_shadowRenderer.setShadowCasters(i, std::move(lists[i]));
+        if (hasGI) m_globalIllumination.setRenderables(std::move(lists.back()));
+      },
+      {cascades});
+  }
+
+  params.visibleRenderables = getVisibleRenderables(
+    renderables, bounds, bvh, camera, memoryResource);
+  const auto opaque = m_jobSystem.schedule([&params, &camera, memoryResource] {
+    ZoneScopedN("SortOpaque");
+    params.opaqueRenderables =
+      filterRenderables(params.visibleRenderables, isOpaque, memoryResource);
+    std::sort(params.opaqueRenderables.begin(),
+              params.opaqueRenderables.end(),
+              SortByDistance{camera, SortOrder::FrontToBack});
+  });
+  params.transparentRenderables = filterRenderables(
+    params.visibleRenderables, isTransparent, memoryResource);
+
+  for (const auto &job : {opaque, shadowCasters})
+    m_jobSystem.wait(job);
+
+  const auto cascadeCasters = m_shadowRenderer.getShadowCasters();
+  m_cullingStats = {
+    .numRenderables = static_cast<uint32_t>(renderables.size()),
+    .numVisible = static_cast<uint32_t>(params.visibleRenderables.size()),
+    .numShadowCasters = hasCullingData ? m_numShadowCasters
+                                       : countShadowCasters(renderables),
+    .numCascades = static_cast<uint32_t>(cascadeCasters.size()),
+  };
+  for (const auto &casters : cascadeCasters)
+    m_cullingStats.numCascadeDraws += static_cast<uint32_t>(casters.size());
+}
+WorldRenderer::FrameGraphKey
+WorldRenderer::_makeFrameGraphKey(const RenderSettings &settings,
+                                  Extent2D resolution,
+                                  const AABB &sceneAABB) const {
+  const auto &params = m_frameParams;
+  return {
+    .outputMode = settings.outputMode,
+    .renderFeatures = settings.renderFeatures,
+    .bloomRadius = settings.bloom.radius,
+    .bloomStrength = settings.bloom.strength,
+    .numPropagations = settings.globalIllumination.numPropagations,
+    .tonemap = settings.tonemap,
+    .debugFlags = settings.debugFlags,
+    .resolution = resolution,
+    .sceneAABB = sceneAABB,
+    .camera = params.frameInfo.camera,
+    .skybox = m_skybox,
+    .hasDirectionalLight = params.directionalLight != nullptr,
+    .maxNumLights = params.maxNumLights,
+  };
+}
+std::size_t WorldRenderer::_hashFrameGraphKey(const FrameGraphKey &key) {
+  std::size_t h{0};
+  hashCombine(h, key.outputMode, key.renderFeatures, key.bloomRadius,
+              key.bloomStrength, key.numPropagations, key.tonemap,
+              key.debugFlags);
+  hashCombine(h, key.resolution.width, key.resolution.height);
+  for (auto i = 0; i < 3; ++i)
+    hashCombine(h, key.sceneAABB.min[i], key.sceneAABB.max[i]);
+  hashCombine(h, key.camera, key.skybox);
+  hashCombine(h, key.hasDirectionalLight, key.maxNumLights);
+  return h;
+}
+void WorldRenderer::_rebuildFrameGraph(const RenderSettings &settings,
+                                       Extent2D resolution,
+                                       const AABB &sceneAABB) {
+  ZoneScopedN("BuildFrameGraph");
+  const auto beginTicks = std::chrono::steady_clock::now();
+
+  m_frameGraph = std::make_unique<FrameGraph>();
+  m_blackboard = std::make_unique<FrameGraphBlackboard>();
+  _buildFrameGraph(*m_frameGraph, *m_blackboard, settings, resolution,
+                   sceneAABB);
+  {
+    ZoneScopedN("CompileFrameGraph");
+    m_frameGraph->compile();
+  }
+
+  const std::chrono::duration<float, std::milli> buildTime =
+    std::chrono::steady_clock::now() - beginTicks;
+  auto &stats = m_frameGraphStats;
+  ++stats.numBuilds;
+  stats.lastBuildTime = buildTime.count();
+  stats.averageBuildTime +=
+    (stats.lastBuildTime - stats.averageBuildTime) / stats.numBuilds;
+}
+
+void WorldRenderer::_buildFrameGraph(FrameGraph &fg,
+                                     FrameGraphBlackboard &blackboard,
+                                     const RenderSettings &settings,
+                                     Extent2D resolution,
+                                     const AABB &sceneAABB) {
+  // Per-frame data goes through m_frameParams (read by the passes when the
+  // graph executes), nothing here may depend on it (see _makeFrameGraphKey).
+  const auto &params = m_frameParams;
+  const auto &camera = *params.frameInfo.camera;
 
   blackboard.add<BRDF>().lut = importTexture(fg, "BRDF LUT", &m_brdf);
   importLightProbe(fg, blackboard, m_globalLightProbe);
 
-  uploadFrameBlock(fg, blackboard,
-                   {
-                     .time = m_time,
-                     .deltaTime = deltaTime,
-                     .resolution = resolution,
-                     .camera = camera,
-                     .features = settings.renderFeatures,
-                     .debugFlags = settings.debugFlags,
-                   });
-
-  auto visibleLights = getVisibleLights(lights, camera.getFrustum());
+  uploadFrameBlock(fg, blackboard, params.frameInfo);
 
   const bool hasShadows = settings.renderFeatures & RenderFeature_Shadows;
-  const auto directionalLight = getFirstDirectionalLight(visibleLights);
-  m_shadowRenderer.buildCascadedShadowMaps(
-    fg, blackboard, camera, hasShadows ? directionalLight : nullptr,
-    renderables);
+  m_shadowRenderer.buildCascadedShadowMaps(fg, blackboard);
 
   const Grid sceneGrid{sceneAABB};
 
   const bool hasGI = settings.renderFeatures & RenderFeature_GI;
-  if (hasGI && directionalLight) {
-    m_globalIllumination.update(fg, blackboard, sceneGrid, camera,
-                                *directionalLight, renderables,
-                                settings.globalIllumination.numPropagations);
+  if (hasGI && params.directionalLight) {
+    m_globalIllumination.addPasses(fg, blackboard, sceneGrid,
+                                   settings.globalIllumination.numPropagations);
   }
 
-  auto visibleRenderables = getVisibleRenderables(renderables, camera);
-
-  auto opaqueRenderables = filterRenderables(visibleRenderables, isOpaque);
-  std::sort(opaqueRenderables.begin(), opaqueRenderables.end(),
-            SortByDistance{camera, SortOrder::FrontToBack});
   m_gBufferPass.addGeometryPass(fg, blackboard, resolution, camera,
-                                opaqueRenderables);
+                                params.opaqueRenderables);
 
-  uploadLights(fg, blackboard, std::move(visibleLights));
+  uploadLights(fg, blackboard, params.visibleLights, params.maxNumLights);
   // Requires depth buffer, must be executed AFTER GBufferPass.
   m_tiledLighting.cullLights(fg, blackboard);
 
-  auto transparentRenderables =
-    filterRenderables(visibleRenderables, isTransparent);
-  m_weightedBlendedPass.addPass(fg, blackboard, camera, transparentRenderables);
+  m_weightedBlendedPass.addPass(fg, blackboard, camera,
+                                params.transparentRenderables);
 
   if (settings.renderFeatures & RenderFeature_SSAO) {
     m_ssao.addPass(fg, blackboard);
@@ -228,7 +607,7 @@ void WorldRenderer::drawFrame(const RenderSettings &settings,
 
   if (settings.debugFlags & DebugFlag_Wireframe) {
     sceneColor.ldr = m_wireframePass.addGeometryPass(
-      fg, blackboard, sceneColor.ldr, camera, visibleRenderables);
+      fg, blackboard, sceneColor.ldr, camera, params.visibleRenderables);
   }
 
   if (hasGI && settings.debugFlags & DebugFlag_VPL) {
@@ -250,26 +629,50 @@ void WorldRenderer::drawFrame(const RenderSettings &settings,
     sceneColor.ldr = afterVignette;
 
   m_finalPass.compose(fg, blackboard, settings.outputMode);
+}
+void WorldRenderer::_preallocate(const RenderSettings &settings,
+                                 Extent2D resolution, const AABB &sceneAABB) {
+  ZoneScoped;
+
+  // The FrameGraph creates transient resources lazily (as it executes the
+  // passes), the setup is enough to learn what they are.
+  TransientResources::Declarations declarations;
   {
-    ZoneScopedN("CompileFrameGraph");
-    fg.compile();
+    FrameGraph fg;
+    FrameGraphBlackboard blackboard;
+    const TransientDeclarationScope scope{declarations};
+    _buildFrameGraph(fg, blackboard, settings, resolution, sceneAABB);
   }
+  m_transientResources.preallocate(declarations);
+}
 
-#if _DEBUG
-  constexpr auto kInterval = 5.0f;
-  static float stopwatch{kInterval};
-  if (stopwatch >= kInterval) {
-    std::ofstream{"fg.dot"} << fg;
-    stopwatch = 0.0f;
+Extent2D WorldRenderer::_selectRenderResolution(Extent2D resolution) {
+  if (resolution == m_lastResolution) {
+    ++m_numStableFrames;
+  } else {
+    m_lastResolution = resolution;
+    m_numStableFrames = 0;
   }
-  stopwatch += deltaTime;
-#endif
 
-  {
-    TracyGpuZone("ExecuteFrameGraph");
-    fg.execute(&m_renderContext, &m_transientResources);
+  if (m_renderResolution == Extent2D{} ||
+      m_numStableFrames >= kNumSettleFrames) {
+    m_renderResolution = resolution;
+  } else {
+    const auto roundUp = [](uint32_t v) {
+      return (v + kSizeClass - 1) / kSizeClass * kSizeClass;
+    };
+    // Hysteresis: keep the current size as long as it covers the window and
+    // is at most one class larger than needed (don't shrink right away).
+    const auto fits = [&roundUp](uint32_t current, uint32_t v) {
+      return current >= v && current <= roundUp(v) + kSizeClass;
+    };
+    if (!fits(m_renderResolution.width, resolution.width) ||
+        !fits(m_renderResolution.height, resolution.height)) {
+      m_renderResolution = {
+        .width = roundUp(resolution.width),
+        .height = roundUp(resolution.height),
+      };
+    }
   }
-
-  m_time += deltaTime;
-  m_transientResources.update(deltaTime);
+  return m_renderResolution;
 }
@@ -22,6 +22,15 @@
 #include "Passes/Blit.hpp"
 #include "Passes/FinalPass.hpp"
 
+#include "UploadFrameBlock.hpp"
+#include "CountingMemoryResource.hpp"
+#include "FrustumCulling.hpp"
+#include "BVH.hpp"
+
+#include <deque>
+#include <memory>
+#include <memory_resource>
+
 struct LightProbe {
   Texture diffuse, specular;
 };
@@ -42,7 +51,8 @@ enum RenderFeature_ : uint32_t {
                           RenderFeature_Bloom | RenderFeature_FXAA |
                           RenderFeature_Vignette,
 
-  RenderFeature_All = RenderFeature_Default | RenderFeature_SSR,
+  RenderFeature_All = RenderFeature_Default | RenderFeature_GI |
+                      RenderFeature_IBL | RenderFeature_SSR,
 };
 
 enum DebugFlag_ : uint32_t {
@@ -53,6 +63,35 @@ enum DebugFlag_ : uint32_t {
   DebugFlag_RadianceOnly = 1 << 3,
 };
 
+struct FrameGraphStats {
+  uint32_t numBuilds{0};     // Setup + compile.
+  uint64_t numReuses{0};     // Frames that executed a retained graph.
+  float lastBuildTime{0.0f}; // In milliseconds.
+  float averageBuildTime{0.0f};
+};
+
+struct FrameArenaStats {
+  // Made by the containers, each one would go to the heap without the arena.
+  uint32_t numAllocations{0};
+  uint32_t numHeapAllocations{0}; // Arena overflow.
+  std::size_t numBytes{0};
+};
+
+// Draws of the last frame, out of the renderables that a pass would draw
+// without culling.
+struct CullingStats {
+  uint32_t numRenderables{0};
+  uint32_t numVisible{0}; // GBuffer + transparency.
+  uint32_t numShadowCasters{0};
+  uint32_t numCascades{0};
+  uint32_t numCascadeDraws{0}; // Summed over the cascades.
+};
+
+enum class CullingMethod {
+  BVH,    // Hierarchical (see buildCullingData).
+  Linear, // Every renderable, 4/8 at once (see cullAABBs).
+};
+
 struct RenderSettings {
   OutputMode outputMode{OutputMode::FinalImage};
   uint32_t renderFeatures{RenderFeature_Default};
@@ -64,25 +103,155 @@ struct RenderSettings {
     int32_t numPropagations{6};
   } globalIllumination;
   Tonemap tonemap{Tonemap::ACES};
+  CullingMethod culling{CullingMethod::BVH};
   uint32_t debugFlags{0u};
 };
 
 class WorldRenderer {
 public:
-  explicit WorldRenderer(RenderContext &);
+  WorldRenderer(RenderContext &, JobSystem &);
   ~WorldRenderer();
 
   void setSkybox(Texture &cubemap);
 
+  [[nodiscard]] TransientResources &getTransientResources();
+
+  /*
+   * @brief Creates every transient resource that the FrameGraph for the given
+   * settings declares (see TransientResources::preallocate), then executes
+   * the graph once, so the pipelines are built too.
+   * @remark Blocking and draws to the back buffer, meant for loading screens
+   * (call RenderContext::endFrame after).
+   */
+  void warmUp(const RenderSettings &, Extent2D resolution, const AABB &,
+              const PerspectiveCamera &, std::span<const Light>,
+              std::span<const Renderable>);
+  // @brief Queues variants of the given settings (each feature toggled, and
+  // all of them enabled), one per drawFrame has its resources preallocated
+  // (the graph of a variant is only set up, never executed).
+  void queueWarmUp(const RenderSettings &, Extent2D resolution);
+
+  // @brief When enabled (default), the FrameGraph is built once and executed
+  // every frame until the settings, resolution or the directional light (or
+  // any other input of the topology) change.
+  void setRetainFrameGraph(bool);
+  [[nodiscard]] const FrameGraphStats &getFrameGraphStats() const;
+  // @return Allocations of the last frame setup (culling, sorting).
+  [[nodiscard]] const FrameArenaStats &getFrameArenaStats() const;
+  [[nodiscard]] const CullingStats &getCullingStats() const;
+
+  // @brief Builds a BVH and a SoA copy of the bounds of the renderables, the
+  // culling of the same span uses them (the bounds of other spans are gathered
+  // every frame). Call once the scene is set up, and again when renderables
+  // are added or removed.
+  void buildCullingData(std::span<const Renderable>);
+  // @brief Call after moving renderables (updating their bounds).
+  void refitCullingData();
+
   void drawFrame(const RenderSettings &, Extent2D resolution, const AABB &,
                  const PerspectiveCamera &, std::span<const Light>,
                  std::span<const Renderable>, float deltaTime);
 
+private:
+  // Inputs that the topology of the FrameGraph depends on.
+  struct FrameGraphKey {
+    OutputMode outputMode;
+    uint32_t renderFeatures;
+    float bloomRadius;
+    float bloomStrength;
+    int32_t numPropagations;
+    Tonemap tonemap;
+    uint32_t debugFlags;
+    Extent2D resolution;
+    AABB sceneAABB;
+    // Passes keep pointers to these.
+    const PerspectiveCamera *camera;
+    const Texture *skybox;
+    bool hasDirectionalLight;
+    uint32_t maxNumLights;
+
+    bool operator==(const FrameGraphKey &) const = default;
+  };
+
+  void _updateFrameParams(const RenderSettings &, Extent2D resolution,
+                          const PerspectiveCamera &, std::span<const Light>,
+                          std::span<const Renderable>, float deltaTime);
+  [[nodiscard]] FrameGraphKey _makeFrameGraphKey(const RenderSettings &,
+                                                 Extent2D resolution,
+                                                 const AABB &) const;
+  [[nodiscard]] static std::size_t _hashFrameGraphKey(const FrameGraphKey &);
+  void _rebuildFrameGraph(const RenderSettings &, Extent2D resolution,
+                          const AABB &);
+  void _buildFrameGraph(FrameGraph &, FrameGraphBlackboard &,
+                        const RenderSettings &, Extent2D resolution,
+                        const AABB &);
+  // @brief Sets up the FrameGraph (without executing it) to collect the
+  // declared resources, and preallocates them.
+  void _preallocate(const RenderSettings &, Extent2D resolution, const AABB &);
+
+  // @return The resolution that the FrameGraph renders at (see drawFrame).
+  [[nodiscard]] Extent2D _selectRenderResolution(Extent2D);
+
 private:
   RenderContext &m_renderContext;
+  JobSystem &m_jobSystem;
 
   float m_time{0.0f};
 
+  Extent2D m_lastResolution{};
+  uint32_t m_numStableFrames{0};
+  Extent2D m_renderResolution{};
+
+  struct WarmUpRequest {
+    RenderSettings settings;
+    Extent2D resolution;
+  };
+  std::deque<WarmUpRequest> m_warmUpQueue;
+
+  // Frame setup allocates from here, released at the beginning of a frame
+  // (see _updateFrameParams).
+  static constexpr std::size_t kFrameArenaSize{256 * 1024};
+  std::unique_ptr<std::byte[]> m_frameArenaBuffer{
+    std::make_unique<std::byte[]>(kFrameArenaSize)};
+  CountingMemoryResource m_frameArenaUpstream{std::pmr::new_delete_resource()};
+  std::pmr::monotonic_buffer_resource m_frameArena{
+    m_frameArenaBuffer.get(), kFrameArenaSize, &m_frameArenaUpstream};
+  CountingMemoryResource m_frameAllocator{&m_frameArena};
+  FrameArenaStats m_frameArenaStats;
+
+  CullingStats m_cullingStats;
+
+  std::span<const Renderable> m_cullingRenderables;
+  AABBArray m_renderableBounds;
+  AABB m_receiverBounds{}; // Of m_renderableBounds (shadow receivers).
+  uint32_t m_numShadowCasters{0}; // In m_cullingRenderables (for the stats).
+  BVH m_bvh;
+
+  // Stable slots for the per-frame inputs, passes keep references to them
+  // (so a retained FrameGraph sees the current frame).
+  struct FrameParams {
+    explicit FrameParams(std::pmr::memory_resource *memoryResource)
+        : visibleLights{memoryResource}, visibleRenderables{memoryResource},
+          opaqueRenderables{memoryResource},
+          transparentRenderables{memoryResource} {}
+
+    FrameInfo frameInfo{};
+    uint32_t maxNumLights{0};
+    std::pmr::vector<const Light *> visibleLights;
+    const Light *directionalLight{nullptr};
+    RenderableList visibleRenderables;
+    RenderableList opaqueRenderables;
+    RenderableList transparentRenderables;
+  };
+  FrameParams m_frameParams{&m_frameAllocator};
+
+  bool m_retainFrameGraph{true};
+  std::unique_ptr<FrameGraph> m_frameGraph;
+  std::unique_ptr<FrameGraphBlackboard> m_blackboard;
+  FrameGraphKey m_frameGraphKey{};
+  std::size_t m_frameGraphKeyHash{0};
+  FrameGraphStats m_frameGraphStats;
+
   IBL m_ibl;
   Texture m_brdf;
 